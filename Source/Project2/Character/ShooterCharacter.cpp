@@ -11,6 +11,7 @@
 #include "Camera/CameraComponent.h"
 #include "TimerManager.h"
 #include "ShooterGameMode.h"
+#include "ShooterHitHistoryComponent.h"
 
 AShooterCharacter::AShooterCharacter()
 {
@@ -36,6 +37,9 @@ AShooterCharacter::AShooterCharacter()
 	SquidMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision); // 碰撞由胶囊体负责
 	SquidMesh->SetHiddenInGame(true);								// 默认隐藏
 
+	// 4. 延迟补偿历史（只在服务器上记录）
+	HitHistory = CreateDefaultSubobject<UShooterHitHistoryComponent>(TEXT("HitHistory"));
+
 	// 默认关闭 TPS 摄像机
 	SquidCamera->SetActive(false);
 
@@ -75,6 +79,17 @@ void AShooterCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
 }
 
+void AShooterCharacter::PossessedBy(AController *NewController)
+{
+	Super::PossessedBy(NewController);
+
+	// 重生后从出生点重新开始记录，不与之前的位置插值
+	if (HitHistory)
+	{
+		HitHistory->ResetHistory();
+	}
+}
+
 void AShooterCharacter::SetupPlayerInputComponent(UInputComponent *PlayerInputComponent)
 {
 	// 基类处理移动/视角/跳跃输入
@@ -13,6 +13,7 @@ class UInputAction;
 class USpringArmComponent;
 class UCameraComponent;
 class UStaticMeshComponent;
+class UShooterHitHistoryComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBulletCountUpdatedDelegate, int32, MagazineSize, int32, Bullets);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDamagedDelegate, float, LifePercent);
@@ -97,6 +98,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components|Squid Form")
 	class USkeletalMeshComponent *SquidMesh;
 
+	// 服务器端胶囊体历史，用于延迟补偿
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components|Lag Compensation")
+	TObjectPtr<UShooterHitHistoryComponent> HitHistory;
+
 	// --- 状态变量 ---
 	bool bIsSquidForm;
 
@@ -140,6 +145,9 @@ protected:
 	/** 绑定输入动作 */
 	virtual void SetupPlayerInputComponent(UInputComponent *InputComponent) override;
 
+	/** 被控制器接管（出生、重生）时清空延迟补偿历史 */
+	virtual void PossessedBy(AController *NewController) override;
+
 public:
 	/** 处理伤害 */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const &DamageEvent, AController *EventInstigator, AActor *DamageCauser) override;
@@ -0,0 +1,133 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterHitHistoryComponent.h"
+#include "ShooterLagCompensation.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "Engine/World.h"
+
+UShooterHitHistoryComponent::UShooterHitHistoryComponent()
+{
+	// 采样由子系统统一驱动，组件自身不 Tick
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UShooterHitHistoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (const ACharacter *Character = Cast<ACharacter>(GetOwner()))
+	{
+		Capsule = Character->GetCapsuleComponent();
+	}
+
+	// 只有服务器需要历史
+	if (Capsule && GetOwner()->HasAuthority())
+	{
+		if (UShooterLagCompensation *LagCompensation = GetWorld()->GetSubsystem<UShooterLagCompensation>())
+		{
+			LagCompensation->RegisterHistory(this);
+		}
+
+		Capsule->TransformUpdated.AddUObject(this, &UShooterHitHistoryComponent::OnCapsuleTransformUpdated);
+	}
+}
+
+void UShooterHitHistoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShooterLagCompensation *LagCompensation = GetWorld()->GetSubsystem<UShooterLagCompensation>())
+	{
+		LagCompensation->UnregisterHistory(this);
+	}
+
+	if (Capsule)
+	{
+		Capsule->TransformUpdated.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UShooterHitHistoryComponent::OnCapsuleTransformUpdated(USceneComponent *Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	// 传送（TeleportTo、SetActorLocation 带 bTeleport）前后的位置不连续，旧历史不能再用于插值
+	if (Teleport != ETeleportType::None)
+	{
+		ResetHistory();
+	}
+}
+
+void UShooterHitHistoryComponent::Record(double Time, double MinInterval)
+{
+	if (!Capsule)
+	{
+		return;
+	}
+
+	// 帧率高于采样率时覆盖最新一条，保证缓冲覆盖的时长不随帧率缩短
+	if (NumSamples > 1 && Time - GetSample(NumSamples - 2).Time < MinInterval)
+	{
+		Head = (Head - 1 + Capacity) % Capacity;
+		--NumSamples;
+	}
+
+	FShooterCapsuleSample &Sample = Samples[Head];
+	Sample.Time = Time;
+	Sample.Location = Capsule->GetComponentLocation();
+	Sample.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	Sample.Radius = Capsule->GetScaledCapsuleRadius();
+
+	Head = (Head + 1) % Capacity;
+	NumSamples = FMath::Min(NumSamples + 1, Capacity);
+}
+
+bool UShooterHitHistoryComponent::GetCapsuleAtTime(double Time, FShooterCapsuleSample &OutSample) const
+{
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	if (Time <= GetSample(0).Time)
+	{
+		OutSample = GetSample(0);
+		return true;
+	}
+
+	if (Time >= GetSample(NumSamples - 1).Time)
+	{
+		OutSample = GetSample(NumSamples - 1);
+		return true;
+	}
+
+	// 二分查找第一条时间 > Time 的采样
+	int32 Low = 1;
+	int32 High = NumSamples - 1;
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (GetSample(Mid).Time > Time)
+		{
+			High = Mid;
+		}
+		else
+		{
+			Low = Mid + 1;
+		}
+	}
+
+	const FShooterCapsuleSample &Before = GetSample(Low - 1);
+	const FShooterCapsuleSample &After = GetSample(Low);
+	const double Alpha = (Time - Before.Time) / FMath::Max(After.Time - Before.Time, UE_SMALL_NUMBER);
+
+	OutSample.Time = Time;
+	OutSample.Location = FMath::Lerp(Before.Location, After.Location, Alpha);
+	OutSample.HalfHeight = FMath::Lerp(Before.HalfHeight, After.HalfHeight, static_cast<float>(Alpha));
+	OutSample.Radius = FMath::Lerp(Before.Radius, After.Radius, static_cast<float>(Alpha));
+	return true;
+}
+
+double UShooterHitHistoryComponent::GetHistoryDuration() const
+{
+	return NumSamples > 1 ? GetSample(NumSamples - 1).Time - GetSample(0).Time : 0.0;
+}
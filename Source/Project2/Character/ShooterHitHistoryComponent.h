@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "Containers/StaticArray.h"
+#include "ShooterHitHistoryComponent.generated.h"
+
+class UCapsuleComponent;
+
+/**
+ *  角色胶囊体在某一时刻的姿态
+ */
+struct FShooterCapsuleSample
+{
+	/** 服务器世界时间 */
+	double Time = 0.0;
+
+	/** 胶囊体中心 */
+	FVector Location = FVector::ZeroVector;
+
+	float HalfHeight = 0.0f;
+	float Radius = 0.0f;
+};
+
+/**
+ *  角色胶囊体历史（仅服务器记录）
+ *  定长环形缓冲，采样由 UShooterLagCompensation 在每帧移动结束后统一写入，不产生堆分配
+ *  胶囊体始终竖直，只记录中心、半高与半径
+ */
+UCLASS(ClassGroup = (Shooter), meta = (BlueprintSpawnableComponent))
+class PROJECT2_API UShooterHitHistoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** 环形缓冲容量（采样数） */
+	static constexpr int32 Capacity = 64;
+
+	UShooterHitHistoryComponent();
+
+	/** 记录当前胶囊体姿态；距上一次采样不足 MinInterval 时覆盖最新一条 */
+	void Record(double Time, double MinInterval);
+
+	/**
+	 * 取得指定时刻的胶囊体（相邻采样线性插值，超出记录范围时取最近的一端）
+	 * @return	没有任何采样时返回 false
+	 */
+	bool GetCapsuleAtTime(double Time, FShooterCapsuleSample &OutSample) const;
+
+	/** 记录覆盖的时间范围（秒） */
+	double GetHistoryDuration() const;
+
+	/** 采样数 */
+	int32 Num() const { return NumSamples; }
+
+	/** 清空历史（传送后、重生被接管时），避免在新旧位置之间插值出不存在的姿态 */
+	void ResetHistory() { NumSamples = 0; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** 胶囊体被传送时清空历史 */
+	void OnCapsuleTransformUpdated(USceneComponent *Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/** 第 Index 旧的采样（0 为最旧） */
+	const FShooterCapsuleSample &GetSample(int32 Index) const { return Samples[(Head - NumSamples + Index + Capacity) % Capacity]; }
+
+	TStaticArray<FShooterCapsuleSample, Capacity> Samples;
+
+	/** 下一次写入的位置 */
+	int32 Head = 0;
+	int32 NumSamples = 0;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UCapsuleComponent> Capsule;
+};
@@ -0,0 +1,198 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterLagCompensation.h"
+#include "ShooterHitHistoryComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Ink/InkStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Record"), STAT_ShooterLagCompensationRecord, STATGROUP_Ink);
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Rewind"), STAT_ShooterLagCompensationRewind, STATGROUP_Ink);
+
+namespace ShooterLagCompensation
+{
+	/** 二分求最早接触时刻的迭代次数（线段 1/65536 精度） */
+	constexpr int32 ContactIterations = 16;
+}
+
+bool UShooterLagCompensation::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// 只在实际游戏世界中运行
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterLagCompensation::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLagCompensation, STATGROUP_Tickables);
+}
+
+void UShooterLagCompensation::RegisterHistory(UShooterHitHistoryComponent *History)
+{
+	Histories.AddUnique(History);
+}
+
+void UShooterLagCompensation::UnregisterHistory(UShooterHitHistoryComponent *History)
+{
+	Histories.RemoveSwap(History);
+}
+
+double UShooterLagCompensation::GetSampleInterval() const
+{
+	// 留出两条余量：最新一条可能被覆盖，最旧一条需要作为插值端点
+	return FMath::Max(MaxRewindTime, 0.0f) / (UShooterHitHistoryComponent::Capacity - 2);
+}
+
+void UShooterLagCompensation::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterLagCompensationRecord);
+
+	if (Histories.IsEmpty())
+	{
+		return;
+	}
+
+	// 可 Tick 对象在所有 Actor 的 Tick 组之后更新，此时本帧移动已经结束
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double Interval = GetSampleInterval();
+	for (int32 Index = Histories.Num() - 1; Index >= 0; --Index)
+	{
+		if (UShooterHitHistoryComponent *History = Histories[Index].Get())
+		{
+			History->Record(Now, Interval);
+		}
+		else
+		{
+			Histories.RemoveAtSwap(Index, EAllowShrinking::No);
+		}
+	}
+}
+
+float UShooterLagCompensation::GetRewindLatency(const APawn *Shooter) const
+{
+	if (!bEnabled || !Shooter)
+	{
+		return 0.0f;
+	}
+
+	// 本地玩家和 AI 看到的就是服务器当前的世界
+	const APlayerController *Controller = Cast<APlayerController>(Shooter->GetController());
+	const APlayerState *PlayerState = Shooter->GetPlayerState();
+	if (!Controller || Controller->IsLocalController() || !PlayerState)
+	{
+		return 0.0f;
+	}
+
+	// 往返延迟：射击者看到的角色落后单程延迟 + 插值延迟，射击请求再经单程延迟到达服务器
+	const float Latency = PlayerState->GetPingInMilliseconds() * 0.001f + InterpolationDelay;
+	return FMath::Clamp(Latency, 0.0f, MaxRewindTime);
+}
+
+bool UShooterLagCompensation::RewindSweep(const FVector &Start, const FVector &End, float Radius, double Time, const AActor *IgnoreActor, FShooterRewindHit &OutHit) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterLagCompensationRewind);
+
+	const FVector Delta = End - Start;
+	bool bHit = false;
+	OutHit.Time = 1.0f;
+
+	for (const TWeakObjectPtr<UShooterHitHistoryComponent> &HistoryPtr : Histories)
+	{
+		const UShooterHitHistoryComponent *History = HistoryPtr.Get();
+		if (!History || History->GetOwner() == IgnoreActor)
+		{
+			continue;
+		}
+
+		FShooterCapsuleSample Capsule;
+		if (!History->GetCapsuleAtTime(Time, Capsule))
+		{
+			continue;
+		}
+
+		// 胶囊体 = 轴线段 + 半径；扫掠球与胶囊体相交等价于球心到轴线段的距离不超过两半径之和
+		const FVector Axis(0.0, 0.0, FMath::Max(Capsule.HalfHeight - Capsule.Radius, 0.0f));
+		const FVector AxisStart = Capsule.Location - Axis;
+		const FVector AxisEnd = Capsule.Location + Axis;
+		const double ContactRadius = Capsule.Radius + Radius;
+		const double ContactRadiusSq = FMath::Square(ContactRadius);
+
+		// 距离沿线段是凸函数：先求最近点，再在 [0, 最近点] 上二分最早接触时刻
+		FVector ClosestOnShot;
+		FVector ClosestOnAxis;
+		FMath::SegmentDistToSegmentSafe(Start, End, AxisStart, AxisEnd, ClosestOnShot, ClosestOnAxis);
+		if (FVector::DistSquared(ClosestOnShot, ClosestOnAxis) > ContactRadiusSq)
+		{
+			continue;
+		}
+
+		const double ClosestTime = Delta.IsNearlyZero() ? 0.0 : FVector::DotProduct(ClosestOnShot - Start, Delta) / Delta.SizeSquared();
+		if (ClosestTime >= OutHit.Time && bHit)
+		{
+			continue;
+		}
+
+		double ContactTime = 0.0;
+		if (FMath::PointDistToSegmentSquared(Start, AxisStart, AxisEnd) > ContactRadiusSq)
+		{
+			double Low = 0.0;
+			double High = ClosestTime;
+			for (int32 Iteration = 0; Iteration < ShooterLagCompensation::ContactIterations; ++Iteration)
+			{
+				const double Mid = 0.5 * (Low + High);
+				if (FMath::PointDistToSegmentSquared(Start + Delta * Mid, AxisStart, AxisEnd) > ContactRadiusSq)
+				{
+					Low = Mid;
+				}
+				else
+				{
+					High = Mid;
+				}
+			}
+			ContactTime = High;
+		}
+
+		if (!bHit || ContactTime < OutHit.Time)
+		{
+			const FVector Center = Start + Delta * ContactTime;
+			const FVector OnAxis = FMath::ClosestPointOnSegment(Center, AxisStart, AxisEnd);
+			const FVector Normal = (Center - OnAxis).GetSafeNormal(UE_SMALL_NUMBER, -Delta.GetSafeNormal());
+
+			bHit = true;
+			OutHit.Actor = History->GetOwner();
+			OutHit.Time = static_cast<float>(ContactTime);
+			OutHit.Location = Center;
+			OutHit.ImpactNormal = Normal;
+			OutHit.ImpactPoint = OnAxis + Normal * Capsule.Radius;
+		}
+	}
+
+	return bHit;
+}
+
+void UShooterLagCompensation::LogStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("ShooterLagCompensation: Enabled=%d Characters=%d SampleInterval=%.4fs"), bEnabled, Histories.Num(), GetSampleInterval());
+	for (const TWeakObjectPtr<UShooterHitHistoryComponent> &HistoryPtr : Histories)
+	{
+		if (const UShooterHitHistoryComponent *History = HistoryPtr.Get())
+		{
+			UE_LOG(LogTemp, Log, TEXT("  %s Samples=%d History=%.3fs"), *GetNameSafe(History->GetOwner()), History->Num(), History->GetHistoryDuration());
+		}
+	}
+}
+
+// ========== 控制台命令 ==========
+
+static FAutoConsoleCommandWithWorld GShooterLagCompensationStatsCommand(
+	TEXT("shooter.LagComp.Stats"),
+	TEXT("Logs lag compensation history per character (server only)."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld *World)
+	{
+		if (const UShooterLagCompensation *LagCompensation = UWorld::GetSubsystem<UShooterLagCompensation>(World))
+		{
+			LagCompensation->LogStats();
+		}
+	}));
@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterLagCompensation.generated.h"
+
+class UShooterHitHistoryComponent;
+class APawn;
+
+/**
+ *  回溯检测的命中结果
+ */
+struct FShooterRewindHit
+{
+	/** 被命中的角色 */
+	AActor *Actor = nullptr;
+
+	/** 命中时球心在线段上的比例（0..1） */
+	float Time = 1.0f;
+
+	/** 命中时的球心位置 */
+	FVector Location = FVector::ZeroVector;
+
+	/** 胶囊体表面上的接触点与法线（回溯姿态下） */
+	FVector ImpactPoint = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::UpVector;
+};
+
+/**
+ *  服务器端延迟补偿
+ *  - 每帧移动结束后统一记录所有已注册角色的胶囊体（UShooterHitHistoryComponent 的定长环形缓冲）
+ *  - 回溯查询把射击线段与各角色在射击者所见时刻的插值胶囊体做解析求交，不使用物理场景，不移动任何角色
+ *
+ *  每次查询的开销为 角色数 x (一次二分查找 + 一次线段-胶囊体求交)
+ *
+ *  射击目前在各端本地发射，不经过服务器，因此还没有调用方；服务器端的射击路径接入后
+ *  用 GetRewindLatency 算出回溯时刻，再用 RewindSweep 检测角色
+ */
+UCLASS(config = Game)
+class PROJECT2_API UShooterLagCompensation : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 是否启用延迟补偿 */
+	UPROPERTY(Config)
+	bool bEnabled = true;
+
+	/** 最长回溯时间（秒），决定历史的采样间隔 */
+	UPROPERTY(Config)
+	float MaxRewindTime = 0.5f;
+
+	/** 客户端对其他角色的插值延迟（秒），加到往返延迟（Ping）之上 */
+	UPROPERTY(Config)
+	float InterpolationDelay = 0.05f;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterHistory(UShooterHitHistoryComponent *History);
+	void UnregisterHistory(UShooterHitHistoryComponent *History);
+
+	/**
+	 * 服务器收到射击时，需要把角色回溯多少秒才是射击者开火时看到的姿态
+	 * 按往返延迟（Ping）加插值延迟计算：射击者看到的角色落后单程延迟 + 插值延迟，射击再经单程延迟到达服务器
+	 * 只对远端玩家控制的 Pawn 生效，本地玩家、AI 或未启用时返回 0
+	 */
+	float GetRewindLatency(const APawn *Shooter) const;
+
+	/**
+	 * 用回溯姿态检测一次射击（扫掠球）
+	 * @param Start			线段起点
+	 * @param End			线段终点
+	 * @param Radius		扫掠球半径
+	 * @param Time			回溯到的服务器时间
+	 * @param IgnoreActor	忽略的角色（射击者）
+	 * @param OutHit		沿线段最早的命中
+	 * @return				是否命中任何角色
+	 */
+	bool RewindSweep(const FVector &Start, const FVector &End, float Radius, double Time, const AActor *IgnoreActor, FShooterRewindHit &OutHit) const;
+
+	/** 已注册的角色数 */
+	int32 GetNumHistories() const { return Histories.Num(); }
+
+	/** 输出各角色的历史时长 */
+	void LogStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** 采样间隔：缓冲容量刚好覆盖 MaxRewindTime */
+	double GetSampleInterval() const;
+
+	TArray<TWeakObjectPtr<UShooterHitHistoryComponent>> Histories;
+};
@@ -0,0 +1,194 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkAtlas.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/Canvas.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Kismet/KismetRenderingLibrary.h"
+
+void UInkAtlas::Initialize(int32 InPageSize, int32 InPadding, EInkTextureEncoding InEncoding)
+{
+    PageSize = FMath::Max(InPageSize, 256);
+    Padding = FMath::Max(InPadding, 0);
+    Encoding = InEncoding;
+}
+
+bool UInkAtlas::Allocate(const FIntPoint &Size, FInkAtlasSlot &OutSlot)
+{
+    const FIntPoint PaddedSize = Size + FIntPoint(Padding * 2);
+    if (Size.X <= 0 || Size.Y <= 0 || PaddedSize.X > PageSize || PaddedSize.Y > PageSize)
+    {
+        return false;
+    }
+
+    // 先尝试已有页，失败再新建一页
+    int32 PageIndex = 0;
+    FIntRect PaddedRect;
+    for (; PageIndex < Pages.Num(); ++PageIndex)
+    {
+        if (AllocateInPage(Pages[PageIndex], PaddedSize, PaddedRect))
+        {
+            break;
+        }
+    }
+
+    if (PageIndex == Pages.Num())
+    {
+        PageIndex = AddPage();
+        if (PageIndex == INDEX_NONE || !AllocateInPage(Pages[PageIndex], PaddedSize, PaddedRect))
+        {
+            return false;
+        }
+    }
+
+    OutSlot.PageIndex = PageIndex;
+    OutSlot.PaddedRect = PaddedRect;
+    OutSlot.Rect = FIntRect(PaddedRect.Min + FIntPoint(Padding), PaddedRect.Min + FIntPoint(Padding) + Size);
+    ++NumSlots;
+
+    // 复用的区域可能残留旧墨水
+    ClearRect(PageIndex, PaddedRect);
+
+    return true;
+}
+
+void UInkAtlas::Free(const FInkAtlasSlot &Slot)
+{
+    if (!Slot.IsValid() || !Pages.IsValidIndex(Slot.PageIndex))
+    {
+        return;
+    }
+
+    Pages[Slot.PageIndex].FreeRects.Add(Slot.PaddedRect);
+    --NumSlots;
+}
+
+bool UInkAtlas::AllocateInPage(FPage &Page, const FIntPoint &PaddedSize, FIntRect &OutRect)
+{
+    // 1. 优先复用已释放的区域（整块占用，释放时整块归还）
+    for (int32 Index = 0; Index < Page.FreeRects.Num(); ++Index)
+    {
+        const FIntRect &FreeRect = Page.FreeRects[Index];
+        if (FreeRect.Width() >= PaddedSize.X && FreeRect.Height() >= PaddedSize.Y)
+        {
+            OutRect = FreeRect;
+            Page.FreeRects.RemoveAtSwap(Index);
+            return true;
+        }
+    }
+
+    // 2. 放入高度合适的已有货架（避免矮物件占用高货架造成浪费）
+    for (FShelf &Shelf : Page.Shelves)
+    {
+        if (Shelf.Height >= PaddedSize.Y && Shelf.Height <= PaddedSize.Y * 2 && PageSize - Shelf.UsedWidth >= PaddedSize.X)
+        {
+            OutRect = FIntRect(FIntPoint(Shelf.UsedWidth, Shelf.Y), FIntPoint(Shelf.UsedWidth + PaddedSize.X, Shelf.Y + PaddedSize.Y));
+            Shelf.UsedWidth += PaddedSize.X;
+            return true;
+        }
+    }
+
+    // 3. 新建货架
+    if (Page.NextShelfY + PaddedSize.Y <= PageSize)
+    {
+        FShelf &Shelf = Page.Shelves.AddDefaulted_GetRef();
+        Shelf.Y = Page.NextShelfY;
+        Shelf.Height = PaddedSize.Y;
+        Shelf.UsedWidth = PaddedSize.X;
+        Page.NextShelfY += PaddedSize.Y;
+
+        OutRect = FIntRect(FIntPoint(0, Shelf.Y), FIntPoint(PaddedSize.X, Shelf.Y + PaddedSize.Y));
+        return true;
+    }
+
+    return false;
+}
+
+int32 UInkAtlas::AddPage()
+{
+    UTextureRenderTarget2D *PageRenderTarget = UKismetRenderingLibrary::CreateRenderTarget2D(
+        this,
+        PageSize,
+        PageSize,
+        InkEncoding::GetRenderTargetFormat(Encoding));
+
+    if (!PageRenderTarget)
+    {
+        UE_LOG(LogTemp, Error, TEXT("InkAtlas: Failed to create %dx%d page!"), PageSize, PageSize);
+        return INDEX_NONE;
+    }
+
+    // 设置清除颜色为黑色（无涂色）
+    PageRenderTarget->ClearColor = FLinearColor::Black;
+    UKismetRenderingLibrary::ClearRenderTarget2D(this, PageRenderTarget, FLinearColor::Black);
+
+    PageRenderTargets.Add(PageRenderTarget);
+    Pages.AddDefaulted();
+
+    UE_LOG(LogTemp, Log, TEXT("InkAtlas: Created page %d (%dx%d)"), Pages.Num() - 1, PageSize, PageSize);
+
+    return Pages.Num() - 1;
+}
+
+void UInkAtlas::ClearRect(int32 PageIndex, const FIntRect &Rect)
+{
+    UTextureRenderTarget2D *PageRenderTarget = GetPageRenderTarget(PageIndex);
+    if (!PageRenderTarget)
+    {
+        return;
+    }
+
+    UCanvas *Canvas = nullptr;
+    FVector2D CanvasSize;
+    FDrawToRenderTargetContext Context;
+
+    UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, PageRenderTarget, Canvas, CanvasSize, Context);
+
+    if (Canvas)
+    {
+        // 不透明混合直接覆盖为黑色
+        Canvas->K2_DrawTexture(
+            nullptr,
+            FVector2D(Rect.Min),
+            FVector2D(Rect.Size()),
+            FVector2D::ZeroVector,
+            FVector2D::UnitVector,
+            FLinearColor::Black,
+            EBlendMode::BLEND_Opaque);
+    }
+
+    UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+}
+
+UTextureRenderTarget2D *UInkAtlas::GetPageRenderTarget(int32 PageIndex) const
+{
+    return PageRenderTargets.IsValidIndex(PageIndex) ? PageRenderTargets[PageIndex].Get() : nullptr;
+}
+
+UMaterialInstanceDynamic *UInkAtlas::GetPageMaterial(UMaterialInterface *BaseMaterial, int32 PageIndex)
+{
+    UTextureRenderTarget2D *PageRenderTarget = GetPageRenderTarget(PageIndex);
+    if (!BaseMaterial || !PageRenderTarget)
+    {
+        return nullptr;
+    }
+
+    const TPair<TObjectKey<UMaterialInterface>, int32> Key(BaseMaterial, PageIndex);
+    if (const int32 *Found = PageMaterialIndices.Find(Key))
+    {
+        return PageMaterials[*Found];
+    }
+
+    UMaterialInstanceDynamic *PageMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+    if (!PageMaterial)
+    {
+        return nullptr;
+    }
+
+    // 对应 M_Inkable_Surface 中的 "InkRT" 参数
+    PageMaterial->SetTextureParameterValue(FName(TEXT("InkRT")), PageRenderTarget);
+    PageMaterial->SetScalarParameterValue(FName(TEXT("InkEncoding")), InkEncoding::GetMaterialSwitch(Encoding));
+
+    PageMaterialIndices.Add(Key, PageMaterials.Add(PageMaterial));
+    return PageMaterial;
+}
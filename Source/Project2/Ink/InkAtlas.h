@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
+#include "InkEncoding.h"
+#include "InkAtlas.generated.h"
+
+class UTextureRenderTarget2D;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+
+/**
+ * 表面在墨水图集中分配到的区域
+ */
+struct FInkAtlasSlot
+{
+    /** 所在页，INDEX_NONE 表示未分配 */
+    int32 PageIndex = INDEX_NONE;
+
+    /** 可绘制区域（页像素坐标） */
+    FIntRect Rect;
+
+    /** 含边距的占用区域，释放时整体归还 */
+    FIntRect PaddedRect;
+
+    bool IsValid() const { return PageIndex != INDEX_NONE; }
+};
+
+/**
+ * 共享墨水图集
+ * 把多个可涂色表面打包进少量大尺寸 RenderTarget 页中，替代每个表面一张 RenderTarget
+ * 同一页、同一基础材质的表面共用一个动态材质实例，以保留绘制合批
+ *
+ * 材质约定：表面材质从 CustomPrimitiveData[Index..Index+3] 读取 (OffsetU, OffsetV, ScaleU, ScaleV)，
+ * 以 InkUV = UV1 * Scale + Offset 采样 "InkRT"；独占 RenderTarget 的表面写入 (0, 0, 1, 1)
+ */
+UCLASS()
+class PROJECT2_API UInkAtlas : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * 初始化图集参数
+     * @param InPageSize	每页边长（像素）
+     * @param InPadding		每个区域四周的边距（像素），防止双线性采样串色
+     * @param InEncoding	页 RenderTarget 的编码
+     */
+    void Initialize(int32 InPageSize, int32 InPadding, EInkTextureEncoding InEncoding);
+
+    /**
+     * 为表面分配一块区域，必要时新建一页
+     * @param Size		需要的区域尺寸（像素）
+     * @param OutSlot	分配结果
+     * @return			尺寸超过页大小或无法创建 RenderTarget 时返回 false
+     */
+    bool Allocate(const FIntPoint &Size, FInkAtlasSlot &OutSlot);
+
+    /** 归还区域 */
+    void Free(const FInkAtlasSlot &Slot);
+
+    /** 获取页的 RenderTarget */
+    UTextureRenderTarget2D *GetPageRenderTarget(int32 PageIndex) const;
+
+    /** 获取（必要时创建）绑定了指定页的共享动态材质实例 */
+    UMaterialInstanceDynamic *GetPageMaterial(UMaterialInterface *BaseMaterial, int32 PageIndex);
+
+    /** 页边长 */
+    int32 GetPageSize() const { return PageSize; }
+
+    /** 单页显存（字节） */
+    int64 GetPageBytes() const { return static_cast<int64>(PageSize) * PageSize * InkEncoding::GetBytesPerTexel(Encoding); }
+
+    /** 页 RenderTarget 的编码 */
+    EInkTextureEncoding GetEncoding() const { return Encoding; }
+
+    /** 页数量 */
+    int32 GetNumPages() const { return PageRenderTargets.Num(); }
+
+    /** 共享动态材质实例数量 */
+    int32 GetNumPageMaterials() const { return PageMaterials.Num(); }
+
+    /** 已分配的区域数量 */
+    int32 GetNumSlots() const { return NumSlots; }
+
+private:
+    /** 页内的一行货架 */
+    struct FShelf
+    {
+        int32 Y = 0;
+        int32 Height = 0;
+        int32 UsedWidth = 0;
+    };
+
+    /** 页的分配状态 */
+    struct FPage
+    {
+        TArray<FShelf> Shelves;
+        int32 NextShelfY = 0;
+
+        /** 已释放、可复用的区域 */
+        TArray<FIntRect> FreeRects;
+    };
+
+    /** 在指定页中分配含边距的区域 */
+    bool AllocateInPage(FPage &Page, const FIntPoint &PaddedSize, FIntRect &OutRect);
+
+    /** 创建新页，返回页下标 */
+    int32 AddPage();
+
+    /** 将页中的区域清为无涂色 */
+    void ClearRect(int32 PageIndex, const FIntRect &Rect);
+
+    int32 PageSize = 4096;
+    int32 Padding = 2;
+    int32 NumSlots = 0;
+    EInkTextureEncoding Encoding = EInkTextureEncoding::TeamChannels;
+
+    TArray<FPage> Pages;
+
+    /** 每页的 RenderTarget */
+    UPROPERTY()
+    TArray<TObjectPtr<UTextureRenderTarget2D>> PageRenderTargets;
+
+    /** 所有共享动态材质实例 */
+    UPROPERTY()
+    TArray<TObjectPtr<UMaterialInstanceDynamic>> PageMaterials;
+
+    /** (基础材质, 页) -> PageMaterials 下标 */
+    TMap<TPair<TObjectKey<UMaterialInterface>, int32>, int32> PageMaterialIndices;
+};
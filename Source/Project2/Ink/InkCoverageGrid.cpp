@@ -0,0 +1,422 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkCoverageGrid.h"
+#include "Math/VectorRegister.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+void FInkCoverageGrid::Init(int32 InWidth, int32 InHeight, int32 InNumTeams)
+{
+    Width = FMath::Max(InWidth, 0);
+    Height = FMath::Max(InHeight, 0);
+    NumTeams = FMath::Clamp(InNumTeams, 0, InkMaxTeams);
+    WordsPerRow = (Width + 63) / 64;
+
+    Words.Reset();
+    Words.SetNumZeroed(NumTeams * Height * WordsPerRow);
+    FMemory::Memzero(TeamTexelCounts);
+
+    Revision = 1;
+    RowRevisions.Reset();
+    RowRevisions.SetNumZeroed(Height);
+}
+
+void FInkCoverageGrid::Reset()
+{
+    FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64));
+    FMemory::Memzero(TeamTexelCounts);
+
+    // 所有行都视为已修改
+    for (uint32 &RowRevision : RowRevisions)
+    {
+        RowRevision = Revision;
+    }
+}
+
+uint8 FInkCoverageGrid::GetOwner(int32 X, int32 Y) const
+{
+    if (X < 0 || Y < 0 || X >= Width || Y >= Height)
+    {
+        return 0;
+    }
+
+    const uint64 Bit = 1ull << (X & 63);
+    for (uint8 Team = 1; Team <= NumTeams; ++Team)
+    {
+        if (Words[GetRowWordIndex(Team, Y) + (X >> 6)] & Bit)
+        {
+            return Team;
+        }
+    }
+
+    return 0;
+}
+
+uint8 FInkCoverageGrid::GetOwnerAtUV(const FVector2D &UV) const
+{
+    // 与 PaintManager 的像素换算一致：Pixel = UV * Resolution
+    return GetOwner(FMath::FloorToInt32(UV.X * Width), FMath::FloorToInt32(UV.Y * Height));
+}
+
+void FInkCoverageGrid::SetOwner(int32 X, int32 Y, uint8 Team, FInkCoverageDelta *OutDelta)
+{
+    if (X < 0 || Y < 0 || X >= Width || Y >= Height)
+    {
+        return;
+    }
+
+    const int32 WordOffset = X >> 6;
+    const uint64 Bit = 1ull << (X & 63);
+
+    for (uint8 PlaneTeam = 1; PlaneTeam <= NumTeams; ++PlaneTeam)
+    {
+        uint64 &Word = Words[GetRowWordIndex(PlaneTeam, Y) + WordOffset];
+        const bool bWasSet = (Word & Bit) != 0;
+        const bool bSet = (PlaneTeam == Team);
+        if (bWasSet == bSet)
+        {
+            continue;
+        }
+
+        // 增量维护队伍像素数
+        const int32 Change = bSet ? 1 : -1;
+        Word = bSet ? (Word | Bit) : (Word & ~Bit);
+        RowRevisions[Y] = Revision;
+        TeamTexelCounts[PlaneTeam - 1] += Change;
+        if (OutDelta)
+        {
+            OutDelta->Texels[PlaneTeam - 1] += Change;
+        }
+    }
+}
+
+namespace InkCoverageGrid
+{
+    /** 按掩码置位或清除，返回该字中像素数的变化 */
+    FORCEINLINE int32 ApplyWordMask(uint64 &Word, uint64 Mask, bool bSet)
+    {
+        if (bSet)
+        {
+            const uint64 Added = Mask & ~Word;
+            Word |= Mask;
+            return static_cast<int32>(FMath::CountBits(Added));
+        }
+
+        const uint64 Removed = Mask & Word;
+        Word &= ~Mask;
+        return -static_cast<int32>(FMath::CountBits(Removed));
+    }
+}
+
+void FInkCoverageGrid::StampCircle(float CenterX, float CenterY, float Radius, uint8 Team, FInkCoverageDelta *OutDelta)
+{
+    if (!IsValid() || Radius <= 0.0f || Team > NumTeams)
+    {
+        return;
+    }
+
+    const float RadiusSq = Radius * Radius;
+    const int32 MinY = FMath::Max(FMath::FloorToInt32(CenterY - Radius), 0);
+    const int32 MaxY = FMath::Min(FMath::CeilToInt32(CenterY + Radius), Height - 1);
+
+    // 每次用 SIMD 求出 4 行的像素区间，浮点运算顺序与 StampCircleReference 逐行计算完全相同
+    const VectorRegister4Float VecCenterX = VectorSetFloat1(CenterX);
+    const VectorRegister4Float VecCenterY = VectorSetFloat1(CenterY);
+    const VectorRegister4Float VecRadiusSq = VectorSetFloat1(RadiusSq);
+    const VectorRegister4Float VecHalf = VectorSetFloat1(0.5f);
+    const VectorRegister4Int VecMaxX = VectorIntSet1(Width - 1);
+
+    alignas(16) float RowDYSq[4];
+    alignas(16) int32 RowMinX[4];
+    alignas(16) int32 RowMaxX[4];
+
+    FInkCoverageDelta Delta;
+    for (int32 Y = MinY; Y <= MaxY; Y += 4)
+    {
+        const VectorRegister4Float RowCenter = MakeVectorRegisterFloat(Y + 0.5f, (Y + 1) + 0.5f, (Y + 2) + 0.5f, (Y + 3) + 0.5f);
+        const VectorRegister4Float DY = VectorSubtract(RowCenter, VecCenterY);
+        const VectorRegister4Float DYSq = VectorMultiply(DY, DY);
+
+        // 圆外的行先钳到 0 再开方，随后按 DYSq 跳过
+        const VectorRegister4Float HalfWidth = VectorSqrt(VectorMax(VectorSubtract(VecRadiusSq, DYSq), VectorZeroFloat()));
+        const VectorRegister4Int SpanMin = VectorIntMax(VectorFloatToInt(VectorCeil(VectorSubtract(VectorSubtract(VecCenterX, HalfWidth), VecHalf))), VectorIntZero());
+        const VectorRegister4Int SpanMax = VectorIntMin(VectorFloatToInt(VectorFloor(VectorSubtract(VectorAdd(VecCenterX, HalfWidth), VecHalf))), VecMaxX);
+
+        VectorStoreAligned(DYSq, RowDYSq);
+        VectorIntStoreAligned(SpanMin, RowMinX);
+        VectorIntStoreAligned(SpanMax, RowMaxX);
+
+        const int32 NumRows = FMath::Min(4, MaxY - Y + 1);
+        for (int32 Lane = 0; Lane < NumRows; ++Lane)
+        {
+            if (RowDYSq[Lane] <= RadiusSq && RowMinX[Lane] <= RowMaxX[Lane])
+            {
+                StampRowSpan(Y + Lane, RowMinX[Lane], RowMaxX[Lane], Team, Delta);
+            }
+        }
+    }
+
+    for (int32 TeamIndex = 0; TeamIndex < InkMaxTeams; ++TeamIndex)
+    {
+        TeamTexelCounts[TeamIndex] += Delta.Texels[TeamIndex];
+        if (OutDelta)
+        {
+            OutDelta->Texels[TeamIndex] += Delta.Texels[TeamIndex];
+        }
+    }
+}
+
+void FInkCoverageGrid::StampRowSpan(int32 Y, int32 MinX, int32 MaxX, uint8 Team, FInkCoverageDelta &Delta)
+{
+    using InkCoverageGrid::ApplyWordMask;
+
+    const int32 FirstWord = MinX >> 6;
+    const int32 LastWord = MaxX >> 6;
+    const uint64 FirstMask = ~0ull << (MinX & 63);
+    const uint64 LastMask = ~0ull >> (63 - (MaxX & 63));
+
+    // 各队伍位平面中同一行相隔 Height * WordsPerRow 个字
+    uint64 *Row = Words.GetData() + GetRowWordIndex(1, Y);
+    const int32 PlaneStride = Height * WordsPerRow;
+
+    bool bRowChanged = false;
+    for (uint8 PlaneTeam = 1; PlaneTeam <= NumTeams; ++PlaneTeam, Row += PlaneStride)
+    {
+        // 目标队伍的位平面置位，其他队伍的位平面清除；同一平面内的变化符号一致，不会相互抵消
+        const bool bSet = (PlaneTeam == Team);
+
+        int32 Change = 0;
+        if (FirstWord == LastWord)
+        {
+            Change = ApplyWordMask(Row[FirstWord], FirstMask & LastMask, bSet);
+        }
+        else
+        {
+            Change = ApplyWordMask(Row[FirstWord], FirstMask, bSet);
+            for (int32 WordIndex = FirstWord + 1; WordIndex < LastWord; ++WordIndex)
+            {
+                Change += ApplyWordMask(Row[WordIndex], ~0ull, bSet);
+            }
+            Change += ApplyWordMask(Row[LastWord], LastMask, bSet);
+        }
+
+        if (Change != 0)
+        {
+            Delta.Texels[PlaneTeam - 1] += Change;
+            bRowChanged = true;
+        }
+    }
+
+    if (bRowChanged)
+    {
+        RowRevisions[Y] = Revision;
+    }
+}
+
+void FInkCoverageGrid::StampCircleReference(float CenterX, float CenterY, float Radius, uint8 Team, FInkCoverageDelta *OutDelta)
+{
+    if (!IsValid() || Radius <= 0.0f || Team > NumTeams)
+    {
+        return;
+    }
+
+    const float RadiusSq = Radius * Radius;
+    const int32 MinY = FMath::Max(FMath::FloorToInt32(CenterY - Radius), 0);
+    const int32 MaxY = FMath::Min(FMath::CeilToInt32(CenterY + Radius), Height - 1);
+
+    for (int32 Y = MinY; Y <= MaxY; ++Y)
+    {
+        // 以像素中心判断是否落在圆内
+        const float DY = (Y + 0.5f) - CenterY;
+        const float DYSq = DY * DY;
+        if (DYSq > RadiusSq)
+        {
+            continue;
+        }
+
+        const float HalfWidth = FMath::Sqrt(RadiusSq - DYSq);
+        const int32 MinX = FMath::Max(FMath::CeilToInt32(CenterX - HalfWidth - 0.5f), 0);
+        const int32 MaxX = FMath::Min(FMath::FloorToInt32(CenterX + HalfWidth - 0.5f), Width - 1);
+
+        for (int32 X = MinX; X <= MaxX; ++X)
+        {
+            SetOwner(X, Y, Team, OutDelta);
+        }
+    }
+}
+
+TConstArrayView<uint64> FInkCoverageGrid::GetPlaneRows(uint8 Team, int32 FirstRow, int32 NumRows) const
+{
+    if (Team < 1 || Team > NumTeams || FirstRow < 0 || NumRows <= 0 || FirstRow + NumRows > Height)
+    {
+        return TConstArrayView<uint64>();
+    }
+
+    return TConstArrayView<uint64>(Words.GetData() + GetRowWordIndex(Team, FirstRow), NumRows * WordsPerRow);
+}
+
+void FInkCoverageGrid::SetPlaneRows(uint8 Team, int32 FirstRow, TConstArrayView<uint64> RowWords, FInkCoverageDelta *OutDelta)
+{
+    if (Team < 1 || Team > NumTeams || WordsPerRow == 0 || RowWords.Num() % WordsPerRow != 0)
+    {
+        return;
+    }
+
+    const int32 NumRows = RowWords.Num() / WordsPerRow;
+    if (FirstRow < 0 || FirstRow + NumRows > Height)
+    {
+        return;
+    }
+
+    // 行尾超出 Width 的填充位必须保持为 0
+    const int32 TailBits = Width & 63;
+    const uint64 TailMask = TailBits ? ((1ull << TailBits) - 1) : ~0ull;
+
+    int32 Change = 0;
+    uint64 *Dest = Words.GetData() + GetRowWordIndex(Team, FirstRow);
+    for (int32 Row = 0; Row < NumRows; ++Row)
+    {
+        bool bRowChanged = false;
+        for (int32 WordIndex = 0; WordIndex < WordsPerRow; ++WordIndex)
+        {
+            const int32 Index = Row * WordsPerRow + WordIndex;
+            const uint64 NewWord = (WordIndex == WordsPerRow - 1) ? (RowWords[Index] & TailMask) : RowWords[Index];
+            if (Dest[Index] != NewWord)
+            {
+                Change += static_cast<int32>(FMath::CountBits(NewWord)) - static_cast<int32>(FMath::CountBits(Dest[Index]));
+                Dest[Index] = NewWord;
+                bRowChanged = true;
+            }
+        }
+
+        if (bRowChanged)
+        {
+            RowRevisions[FirstRow + Row] = Revision;
+        }
+    }
+
+    TeamTexelCounts[Team - 1] += Change;
+    if (OutDelta)
+    {
+        OutDelta->Texels[Team - 1] += Change;
+    }
+}
+
+bool FInkCoverageGrid::ClearRowsMasked(int32 FirstRow, TConstArrayView<uint64> MaskWords, FInkCoverageDelta *OutDelta)
+{
+    if (WordsPerRow == 0 || MaskWords.Num() % WordsPerRow != 0)
+    {
+        return false;
+    }
+
+    const int32 NumRows = MaskWords.Num() / WordsPerRow;
+    if (FirstRow < 0 || FirstRow + NumRows > Height)
+    {
+        return false;
+    }
+
+    bool bAnyChanged = false;
+    for (uint8 Team = 1; Team <= NumTeams; ++Team)
+    {
+        int32 Change = 0;
+        uint64 *Dest = Words.GetData() + GetRowWordIndex(Team, FirstRow);
+        for (int32 Row = 0; Row < NumRows; ++Row)
+        {
+            int32 RowCleared = 0;
+            for (int32 WordIndex = 0; WordIndex < WordsPerRow; ++WordIndex)
+            {
+                const int32 Index = Row * WordsPerRow + WordIndex;
+                RowCleared += static_cast<int32>(FMath::CountBits(Dest[Index] & MaskWords[Index]));
+                Dest[Index] &= ~MaskWords[Index];
+            }
+
+            if (RowCleared > 0)
+            {
+                RowRevisions[FirstRow + Row] = Revision;
+                Change -= RowCleared;
+            }
+        }
+
+        if (Change != 0)
+        {
+            bAnyChanged = true;
+            TeamTexelCounts[Team - 1] += Change;
+            if (OutDelta)
+            {
+                OutDelta->Texels[Team - 1] += Change;
+            }
+        }
+    }
+
+    return bAnyChanged;
+}
+
+// ========== 自动化测试 ==========
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInkCoverageGridRasterTest, "Project2.Ink.CoverageGrid.RasterMatchesReference",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool FInkCoverageGridRasterTest::RunTest(const FString &Parameters)
+{
+    struct FStampParams
+    {
+        float X, Y, Radius;
+        uint8 Team;
+    };
+
+    constexpr int32 NumStamps = 10000;
+
+    // 宽度不是 64 的整数倍，覆盖行尾不完整的字；圆心可以落在网格外；队伍 0 覆盖擦除
+    constexpr int32 GridWidth = 509;
+    constexpr int32 GridHeight = 263;
+
+    FRandomStream Random(0x494E4B);
+    TArray<FStampParams> Stamps;
+    Stamps.Reserve(NumStamps);
+    for (int32 Index = 0; Index < NumStamps; ++Index)
+    {
+        Stamps.Add({
+            Random.FRandRange(-32.0f, GridWidth + 32.0f),
+            Random.FRandRange(-32.0f, GridHeight + 32.0f),
+            Random.FRandRange(0.25f, 96.0f),
+            static_cast<uint8>(Random.RandRange(0, InkMaxTeams))});
+    }
+
+    FInkCoverageGrid Fast;
+    FInkCoverageGrid Reference;
+    Fast.Init(GridWidth, GridHeight);
+    Reference.Init(GridWidth, GridHeight);
+
+    FInkCoverageDelta FastDelta;
+    FInkCoverageDelta ReferenceDelta;
+
+    for (const FStampParams &Stamp : Stamps)
+    {
+        Fast.StampCircle(Stamp.X, Stamp.Y, Stamp.Radius, Stamp.Team, &FastDelta);
+        Reference.StampCircleReference(Stamp.X, Stamp.Y, Stamp.Radius, Stamp.Team, &ReferenceDelta);
+    }
+
+    for (uint8 Team = 1; Team <= InkMaxTeams; ++Team)
+    {
+        const TConstArrayView<uint64> FastWords = Fast.GetPlaneRows(Team, 0, GridHeight);
+        const TConstArrayView<uint64> ReferenceWords = Reference.GetPlaneRows(Team, 0, GridHeight);
+        TestTrue(FString::Printf(TEXT("Team %d texels match"), Team), FMemory::Memcmp(FastWords.GetData(), ReferenceWords.GetData(), FastWords.NumBytes()) == 0);
+        TestEqual(FString::Printf(TEXT("Team %d texel count"), Team), Fast.GetTeamTexelCount(Team), Reference.GetTeamTexelCount(Team));
+        TestEqual(FString::Printf(TEXT("Team %d delta"), Team), FastDelta.Texels[Team - 1], ReferenceDelta.Texels[Team - 1]);
+    }
+
+    for (int32 Y = 0; Y < GridHeight; ++Y)
+    {
+        if (Fast.GetRowRevision(Y) != Reference.GetRowRevision(Y))
+        {
+            AddError(FString::Printf(TEXT("Row %d revision mismatch"), Y));
+            break;
+        }
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
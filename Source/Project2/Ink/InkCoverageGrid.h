@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 覆盖网格可区分的队伍数量（对应 E_Team 中除 None 以外的枚举） */
+constexpr int32 InkMaxTeams = 2;
+
+/**
+ * 一次写入造成的各队伍像素数变化（下标为队伍编码 - 1）
+ */
+struct FInkCoverageDelta
+{
+    int32 Texels[InkMaxTeams] = {};
+
+    bool IsZero() const
+    {
+        for (int32 Count : Texels)
+        {
+            if (Count != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * CPU 端涂色归属网格
+ * 每个队伍一张位平面（1 bit / 像素），与 GPU RenderTarget 同步更新
+ * 用于在不回读 GPU 的情况下 O(1) 查询某个像素属于哪支队伍（-nullrhi 下同样可用）
+ *
+ * 队伍编码与 E_Team 的底层值一致：0 = 无归属，1..InkMaxTeams = 对应队伍
+ * 每个队伍的像素数在写入时增量维护，查询为常数时间
+ */
+struct PROJECT2_API FInkCoverageGrid
+{
+public:
+    /** 按指定尺寸分配网格并清空 */
+    void Init(int32 InWidth, int32 InHeight, int32 InNumTeams = InkMaxTeams);
+
+    /** 清除所有归属 */
+    void Reset();
+
+    /** 是否已分配 */
+    bool IsValid() const { return Width > 0 && Height > 0 && NumTeams > 0; }
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+    int32 GetNumTeams() const { return NumTeams; }
+
+    /** 查询像素归属队伍（越界返回 0） */
+    uint8 GetOwner(int32 X, int32 Y) const;
+
+    /** 按 UV（0-1）查询归属队伍 */
+    uint8 GetOwnerAtUV(const FVector2D &UV) const;
+
+    /**
+     * 设置像素归属（Team 为 0 表示清除）
+     * @param OutDelta	可选，累加本次修改造成的各队伍像素数变化
+     */
+    void SetOwner(int32 X, int32 Y, uint8 Team, FInkCoverageDelta *OutDelta = nullptr);
+
+    /**
+     * 以网格像素为单位写入一个圆形画刷
+     * 用 VectorRegister 每次求出 4 行的圆内像素区间，再按 64 位字整体写入位平面，
+     * 像素数变化用 popcount 统计；64 像素以内的画刷每行只涉及一到两个字
+     * @param CenterX, CenterY	圆心（像素，可为小数）
+     * @param Radius			半径（像素）
+     * @param Team				写入的队伍编码
+     * @param OutDelta			可选，累加被覆盖像素在各队伍间的变化（包括从其他队伍翻转的像素）
+     */
+    void StampCircle(float CenterX, float CenterY, float Radius, uint8 Team, FInkCoverageDelta *OutDelta = nullptr);
+
+    /** StampCircle 的逐像素参考实现，结果必须与 StampCircle 完全一致（见自动化测试 Project2.Ink.CoverageGrid.RasterMatchesReference） */
+    void StampCircleReference(float CenterX, float CenterY, float Radius, uint8 Team, FInkCoverageDelta *OutDelta = nullptr);
+
+    /** 指定队伍当前拥有的像素数 */
+    int32 GetTeamTexelCount(uint8 Team) const { return (Team >= 1 && Team <= NumTeams) ? TeamTexelCounts[Team - 1] : 0; }
+
+    /** 网格像素总数 */
+    int32 GetTotalTexels() const { return Width * Height; }
+
+    /** 网格占用的内存（字节） */
+    SIZE_T GetAllocatedSize() const { return Words.GetAllocatedSize() + RowRevisions.GetAllocatedSize(); }
+
+    // ========== 快照 ==========
+
+    /** 每行占用的 64 位字数 */
+    int32 GetWordsPerRow() const { return WordsPerRow; }
+
+    /** 指定队伍位平面中 [FirstRow, FirstRow + NumRows) 的连续字数据 */
+    TConstArrayView<uint64> GetPlaneRows(uint8 Team, int32 FirstRow, int32 NumRows) const;
+
+    /**
+     * 覆盖写入指定队伍位平面中从 FirstRow 开始的连续行（快照恢复），像素数增量更新
+     * 调用方负责保证写入后各队伍位平面互斥
+     * @param RowWords	行数据，长度必须是 WordsPerRow 的整数倍
+     * @param OutDelta	可选，累加各队伍像素数变化
+     */
+    void SetPlaneRows(uint8 Team, int32 FirstRow, TConstArrayView<uint64> RowWords, FInkCoverageDelta *OutDelta = nullptr);
+
+    /**
+     * 清除从 FirstRow 开始的连续行中掩码为 1 的像素（所有队伍），用于墨水衰减
+     * @param MaskWords	掩码，长度必须是 WordsPerRow 的整数倍
+     * @param OutDelta	可选，累加各队伍像素数变化
+     * @return			是否有像素被清除
+     */
+    bool ClearRowsMasked(int32 FirstRow, TConstArrayView<uint64> MaskWords, FInkCoverageDelta *OutDelta = nullptr);
+
+    /**
+     * 记录当前修订号：之后被修改的行，其修订号都大于返回值
+     * 用于生成自某次快照以来的增量
+     */
+    uint32 CaptureRevision() { return Revision++; }
+
+    /** 指定行最近一次被修改时的修订号（从未修改为 0） */
+    uint32 GetRowRevision(int32 Y) const { return RowRevisions.IsValidIndex(Y) ? RowRevisions[Y] : 0; }
+
+private:
+    /** 将第 Y 行的像素区间 [MinX, MaxX] 写为 Team，Delta 累加各队伍像素数变化 */
+    void StampRowSpan(int32 Y, int32 MinX, int32 MaxX, uint8 Team, FInkCoverageDelta &Delta);
+
+    /** 计算指定队伍位平面中某行的首个字索引 */
+    int32 GetRowWordIndex(uint8 Team, int32 Y) const { return ((Team - 1) * Height + Y) * WordsPerRow; }
+
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 WordsPerRow = 0;
+    int32 NumTeams = 0;
+
+    /** 位平面数据：[Team][Row][Word] */
+    TArray<uint64> Words;
+
+    /** 各队伍像素数（下标为队伍编码 - 1） */
+    int32 TeamTexelCounts[InkMaxTeams] = {};
+
+    /** 当前修订号，修改行时写入 RowRevisions */
+    uint32 Revision = 1;
+
+    /** 每行最近一次修改时的修订号 */
+    TArray<uint32> RowRevisions;
+};
@@ -0,0 +1,244 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkDecay.h"
+#include "InkSystemComponent.h"
+#include "InkWorldSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+namespace InkDecay
+{
+    /** 清除概率低于该值（1/256 为单位）时推迟到之后的访问，避免量化误差累积 */
+    constexpr uint32 MinThreshold = 8;
+}
+
+FInkDecayScheduler::~FInkDecayScheduler()
+{
+    Reset();
+}
+
+void FInkDecayScheduler::Reset()
+{
+    if (PendingTask.IsValid())
+    {
+        PendingTask.Wait();
+        PendingTask = {};
+    }
+
+    ReadyTiles.Reset();
+    NextReadyTile = 0;
+    DirtyRows.Reset();
+    SweepSurfaces.Reset();
+    SweepSurfaceIndex = 0;
+    SweepRow = 0;
+    LastVisitTime.Reset();
+}
+
+void FInkDecayScheduler::Tick(UInkWorldSubsystem &Subsystem, const FInkDecaySettings &Settings)
+{
+    const double Deadline = FPlatformTime::Seconds() + Settings.BudgetMicroseconds * 1e-6;
+
+    // 取回上一帧调度的分块；任务尚未完成时不阻塞游戏线程
+    if (PendingTask.IsValid() && NextReadyTile >= ReadyTiles.Num())
+    {
+        if (!PendingTask.IsCompleted())
+        {
+            return;
+        }
+
+        ReadyTiles = MoveTemp(PendingTask.GetResult());
+        NextReadyTile = 0;
+        PendingTask = {};
+    }
+
+    const bool bAllApplied = ApplyTiles(Deadline);
+
+    // 只上传本帧被修改的行
+    for (const TPair<TObjectKey<UInkSystemComponent>, FIntPoint> &Pair : DirtyRows)
+    {
+        if (UInkSystemComponent *Surface = Pair.Key.ResolveObjectPtr())
+        {
+            Surface->RefreshInkRows(Pair.Value.X, Pair.Value.Y - Pair.Value.X);
+        }
+    }
+    DirtyRows.Reset();
+
+    if (bAllApplied && !PendingTask.IsValid())
+    {
+        ScheduleTiles(Subsystem, Settings, Subsystem.GetWorld()->GetTimeSeconds());
+    }
+}
+
+bool FInkDecayScheduler::ApplyTiles(double Deadline)
+{
+    while (NextReadyTile < ReadyTiles.Num())
+    {
+        // 每帧至少应用一个分块，保证预算很小时也能推进
+        const FTile &Tile = ReadyTiles[NextReadyTile++];
+        UInkSystemComponent *Surface = Tile.Surface.Get();
+        if (Surface && Surface->ApplyDecayMask(Tile.FirstRow, Tile.ClearMask))
+        {
+            const FIntPoint TileRows(Tile.FirstRow, Tile.FirstRow + Tile.NumRows);
+            FIntPoint &Rows = DirtyRows.FindOrAdd(Surface, TileRows);
+            Rows.X = FMath::Min(Rows.X, TileRows.X);
+            Rows.Y = FMath::Max(Rows.Y, TileRows.Y);
+        }
+
+        if (FPlatformTime::Seconds() >= Deadline)
+        {
+            break;
+        }
+    }
+
+    if (NextReadyTile < ReadyTiles.Num())
+    {
+        return false;
+    }
+
+    ReadyTiles.Reset();
+    NextReadyTile = 0;
+    return true;
+}
+
+void FInkDecayScheduler::ScheduleTiles(UInkWorldSubsystem &Subsystem, const FInkDecaySettings &Settings, double Now)
+{
+    const int32 TileRows = FMath::Max(Settings.TileRows, 1);
+    const double HalfLife = FMath::Max(Settings.HalfLife, 0.001f);
+
+    TArray<FTile> Tiles;
+    bool bStartedSweep = false;
+
+    while (Tiles.Num() < Settings.MaxTilesPerFrame)
+    {
+        if (SweepSurfaceIndex >= SweepSurfaces.Num())
+        {
+            // 同一帧内不重复开始新一轮
+            if (bStartedSweep)
+            {
+                break;
+            }
+            bStartedSweep = true;
+
+            // 新一轮：重新收集有墨水的表面，并清理已销毁表面的访问记录
+            TArray<UInkSystemComponent *> Surfaces;
+            Subsystem.GetRegisteredSurfaces(Surfaces);
+
+            SweepSurfaces.Reset();
+            for (UInkSystemComponent *Surface : Surfaces)
+            {
+                if (Surface->HasAnyInk())
+                {
+                    SweepSurfaces.Add(Surface);
+                }
+            }
+            SweepSurfaceIndex = 0;
+            SweepRow = 0;
+
+            for (auto It = LastVisitTime.CreateIterator(); It; ++It)
+            {
+                if (!It.Key().ResolveObjectPtr())
+                {
+                    It.RemoveCurrent();
+                }
+            }
+
+            if (SweepSurfaces.IsEmpty())
+            {
+                break;
+            }
+        }
+
+        UInkSystemComponent *Surface = SweepSurfaces[SweepSurfaceIndex].Get();
+        const FInkCoverageGrid *Grid = Surface ? &Surface->GetCoverageGrid() : nullptr;
+        if (!Grid || !Grid->IsValid() || SweepRow >= Grid->GetHeight())
+        {
+            ++SweepSurfaceIndex;
+            SweepRow = 0;
+            continue;
+        }
+
+        if (SweepRow == 0)
+        {
+            // 开始访问该表面：按距上一次访问的时间计算清除概率
+            double &LastTime = LastVisitTime.FindOrAdd(Surface, Now);
+            const double Probability = 1.0 - FMath::Pow(0.5, (Now - LastTime) / HalfLife);
+            SweepThreshold = static_cast<uint32>(FMath::Clamp(FMath::RoundToInt32(Probability * 256.0), 0, 256));
+
+            // 概率太小时跳过本次访问，保留上一次的时间继续累积
+            if (SweepThreshold < InkDecay::MinThreshold)
+            {
+                ++SweepSurfaceIndex;
+                continue;
+            }
+            LastTime = Now;
+        }
+
+        FTile &Tile = Tiles.AddDefaulted_GetRef();
+        Tile.Surface = Surface;
+        Tile.FirstRow = SweepRow;
+        Tile.NumRows = FMath::Min(TileRows, Grid->GetHeight() - SweepRow);
+        Tile.WordsPerRow = Grid->GetWordsPerRow();
+        Tile.Threshold = SweepThreshold;
+        Tile.Seed = NextSeed;
+
+        NextSeed = NextSeed * 6364136223846793005ull + 1442695040888963407ull;
+        SweepRow += Tile.NumRows;
+    }
+
+    if (!Tiles.IsEmpty())
+    {
+        PendingTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Tiles = MoveTemp(Tiles)]() mutable
+        {
+            for (FTile &Tile : Tiles)
+            {
+                BuildClearMask(Tile);
+            }
+            return MoveTemp(Tiles);
+        });
+    }
+}
+
+void FInkDecayScheduler::BuildClearMask(FTile &Tile)
+{
+    Tile.ClearMask.SetNumUninitialized(Tile.NumRows * Tile.WordsPerRow);
+
+    if (Tile.Threshold >= 256)
+    {
+        for (uint64 &Word : Tile.ClearMask)
+        {
+            Word = ~0ull;
+        }
+        return;
+    }
+
+    // xorshift64*
+    uint64 State = Tile.Seed | 1;
+    auto NextRandom = [&State]()
+    {
+        State ^= State >> 12;
+        State ^= State << 25;
+        State ^= State >> 27;
+        return State * 0x2545F4914F6CDD1Dull;
+    };
+
+    for (uint64 &Word : Tile.ClearMask)
+    {
+        // 位切片比较：64 个 8 位随机数同时与阈值比较，随机数小于阈值的位置为 1，概率为 Threshold / 256
+        uint64 Less = 0;
+        uint64 Equal = ~0ull;
+        for (int32 Bit = 7; Bit >= 0; --Bit)
+        {
+            const uint64 Random = NextRandom();
+            if ((Tile.Threshold >> Bit) & 1)
+            {
+                Less |= Equal & ~Random;
+                Equal &= Random;
+            }
+            else
+            {
+                Equal &= ~Random;
+            }
+        }
+        Word = Less;
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "UObject/ObjectKey.h"
+
+class UInkSystemComponent;
+class UInkWorldSubsystem;
+
+/**
+ * 墨水衰减参数（来自 UInkWorldSubsystem 的配置）
+ */
+struct FInkDecaySettings
+{
+    /** 墨水像素数减半所需的时间（秒） */
+    float HalfLife = 60.0f;
+
+    /** 每个分块包含的网格行数 */
+    int32 TileRows = 32;
+
+    /** 每帧最多调度的分块数 */
+    int32 MaxTilesPerFrame = 16;
+
+    /** 游戏线程每帧用于应用衰减和上传脏区域的预算（微秒） */
+    float BudgetMicroseconds = 250.0f;
+};
+
+/**
+ * 分时墨水衰减
+ *
+ * 按轮询顺序遍历有墨水的表面，每个表面按 TileRows 行切成分块
+ * 每帧调度至多 MaxTilesPerFrame 个分块，由任务系统在工作线程上生成随机清除掩码，
+ * 下一帧在游戏线程上按预算应用掩码（未用完的分块留到之后的帧），
+ * 最后只把被修改的行重新绘制到各表面的 RenderTarget
+ *
+ * 清除概率按距该表面上一次被访问的时间计算：p = 1 - 0.5^(dt / HalfLife)，
+ * 因此不论表面数量多少、一轮需要多少帧，衰减速度都与 HalfLife 一致
+ */
+class PROJECT2_API FInkDecayScheduler
+{
+public:
+    ~FInkDecayScheduler();
+
+    /** 每帧调用一次 */
+    void Tick(UInkWorldSubsystem &Subsystem, const FInkDecaySettings &Settings);
+
+    /** 等待进行中的任务并清空所有状态 */
+    void Reset();
+
+private:
+    /** 一个分块：网格中的连续行及其清除掩码 */
+    struct FTile
+    {
+        TWeakObjectPtr<UInkSystemComponent> Surface;
+        int32 FirstRow = 0;
+        int32 NumRows = 0;
+        int32 WordsPerRow = 0;
+
+        /** 清除概率（1/256 为单位，256 表示全部清除） */
+        uint32 Threshold = 0;
+
+        uint64 Seed = 0;
+
+        /** 工作线程生成的掩码，1 表示清除 */
+        TArray<uint64> ClearMask;
+    };
+
+    /** 在工作线程上为分块生成掩码 */
+    static void BuildClearMask(FTile &Tile);
+
+    /** 应用已完成的分块，返回是否全部应用完毕 */
+    bool ApplyTiles(double Deadline);
+
+    /** 从轮询游标处选出下一批分块 */
+    void ScheduleTiles(UInkWorldSubsystem &Subsystem, const FInkDecaySettings &Settings, double Now);
+
+    /** 工作线程上正在生成掩码的分块 */
+    UE::Tasks::TTask<TArray<FTile>> PendingTask;
+
+    /** 掩码已生成、等待应用的分块 */
+    TArray<FTile> ReadyTiles;
+    int32 NextReadyTile = 0;
+
+    /** 本帧被修改的行区间（按表面），应用结束后统一上传 */
+    TMap<TObjectKey<UInkSystemComponent>, FIntPoint> DirtyRows;
+
+    /** 本轮遍历的表面（每轮开始时重新收集有墨水的表面） */
+    TArray<TWeakObjectPtr<UInkSystemComponent>> SweepSurfaces;
+    int32 SweepSurfaceIndex = 0;
+    int32 SweepRow = 0;
+
+    /** 当前表面本次访问使用的清除概率 */
+    uint32 SweepThreshold = 0;
+
+    /** 各表面上一次开始被访问的时间 */
+    TMap<TObjectKey<UInkSystemComponent>, double> LastVisitTime;
+
+    uint64 NextSeed = 0x9E3779B97F4A7C15ull;
+};
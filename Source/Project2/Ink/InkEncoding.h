@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "InkEncoding.generated.h"
+
+/**
+ * 墨水 RenderTarget 的编码方式（由 UInkWorldSubsystem::InkTextureEncoding 配置，世界生命周期内固定）
+ */
+UENUM()
+enum class EInkTextureEncoding : uint8
+{
+    /** RG8：Team1 写 R 通道，Team2 写 G 通道，每像素 2 字节，只支持两个队伍 */
+    TeamChannels,
+
+    /** R8：高 3 位为调色板下标（队伍 - 1），低 5 位为覆盖度，每像素 1 字节，最多 8 个队伍 */
+    PackedR8,
+};
+
+/**
+ * 墨水纹理编码约定（C++ 恢复路径与画刷 / 表面材质共用）
+ *
+ * PackedR8 下单个字节 Value = (Team - 1) << 5 | Coverage，Coverage 为 0 表示无墨水
+ *
+ * 画刷材质（M_Brush_Stamp）：
+ *   "InkEncoding"		0 = TeamChannels，1 = PackedR8
+ *   "TeamID"			TeamChannels 下使用，0.0 = Team1，1.0 = Team2
+ *   "InkPaletteBase"	PackedR8 下使用，等于 GetPaletteBase(Team) / 255
+ *   PackedR8 下输出 R = InkPaletteBase + Mask * 31 / 255，Mask 为 0 的像素 clip，
+ *   以不透明方式覆盖（后画者拥有该像素，与 CPU 覆盖网格一致）
+ *
+ * 表面材质（M_Inkable_Surface）：
+ *   "InkEncoding"		同上
+ *   PackedR8 下必须以 Point 过滤采样 "InkRT"（线性过滤会混合不同队伍的下标），
+ *   解码 Palette = floor(R * 255 / 32)，Coverage = (R * 255 - Palette * 32) / 31，
+ *   再按 Palette 查队伍颜色，覆盖度用于边缘过渡
+ */
+namespace InkEncoding
+{
+    constexpr int32 CoverageBits = 5;
+    constexpr uint8 CoverageMax = (1 << CoverageBits) - 1;
+
+    /** PackedR8 可表示的队伍数 */
+    constexpr int32 MaxPackedTeams = 1 << (8 - CoverageBits);
+
+    /** TeamChannels 可表示的队伍数 */
+    constexpr int32 MaxChannelTeams = 2;
+
+    /** 编码一个 PackedR8 像素；Team 为 0（None）或超出范围时返回 0（无墨水） */
+    inline uint8 EncodeTexel(uint8 Team, uint8 Coverage = CoverageMax)
+    {
+        if (Team == 0 || Team > MaxPackedTeams || Coverage == 0)
+        {
+            return 0;
+        }
+        return static_cast<uint8>(((Team - 1) << CoverageBits) | FMath::Min(Coverage, CoverageMax));
+    }
+
+    /** 队伍调色板下标左移后的值（覆盖度为 0），画刷材质在此基础上加覆盖度 */
+    inline uint8 GetPaletteBase(uint8 Team)
+    {
+        return Team > 0 && Team <= MaxPackedTeams ? static_cast<uint8>((Team - 1) << CoverageBits) : 0;
+    }
+
+    /** 解码 PackedR8 像素的队伍，无墨水时返回 0 */
+    inline uint8 DecodeTeam(uint8 Value)
+    {
+        return (Value & CoverageMax) != 0 ? static_cast<uint8>((Value >> CoverageBits) + 1) : 0;
+    }
+
+    inline int32 GetBytesPerTexel(EInkTextureEncoding Encoding)
+    {
+        return Encoding == EInkTextureEncoding::PackedR8 ? 1 : 2;
+    }
+
+    inline ETextureRenderTargetFormat GetRenderTargetFormat(EInkTextureEncoding Encoding)
+    {
+        return Encoding == EInkTextureEncoding::PackedR8 ? ETextureRenderTargetFormat::RTF_R8 : ETextureRenderTargetFormat::RTF_RG8;
+    }
+
+    /** 恢复路径上传用的纹理格式（RTF_R8 对应 PF_G8） */
+    inline EPixelFormat GetPixelFormat(EInkTextureEncoding Encoding)
+    {
+        return Encoding == EInkTextureEncoding::PackedR8 ? PF_G8 : PF_R8G8;
+    }
+
+    /** 材质 "InkEncoding" 参数值 */
+    inline float GetMaterialSwitch(EInkTextureEncoding Encoding)
+    {
+        return Encoding == EInkTextureEncoding::PackedR8 ? 1.0f : 0.0f;
+    }
+}
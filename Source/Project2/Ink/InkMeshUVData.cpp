@@ -0,0 +1,302 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkMeshUVData.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Algo/Sort.h"
+
+TSharedPtr<const FInkMeshUVData> FInkMeshUVData::Build(UStaticMesh *Mesh, int32 UVChannel)
+{
+    FStaticMeshRenderData *RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+    if (!RenderData || RenderData->LODResources.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    FStaticMeshLODResources &LOD = RenderData->LODResources[0];
+    FPositionVertexBuffer &Positions = LOD.VertexBuffers.PositionVertexBuffer;
+    FStaticMeshVertexBuffer &VertexData = LOD.VertexBuffers.StaticMeshVertexBuffer;
+    const FIndexArrayView Indices = LOD.IndexBuffer.GetArrayView();
+
+    // 打包版本中若未开启 CPU Access，顶点 / 索引数据不会保留在内存中
+    if (Indices.Num() == 0 || !Positions.GetVertexData() || !VertexData.GetTexCoordData())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkMeshUVData: Mesh '%s' has no CPU-accessible render data. Enable 'Allow CPU Access'."),
+               *GetNameSafe(Mesh));
+        return nullptr;
+    }
+
+    if ((int32)VertexData.GetNumTexCoords() <= UVChannel)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkMeshUVData: Mesh '%s' has no UV channel %d."), *GetNameSafe(Mesh), UVChannel);
+        return nullptr;
+    }
+
+    TArray<FBuildTriangle> BuildTriangles;
+    BuildTriangles.Reserve(Indices.Num() / 3);
+
+    for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+    {
+        const uint32 I0 = Indices[Index];
+        const uint32 I1 = Indices[Index + 1];
+        const uint32 I2 = Indices[Index + 2];
+
+        FBuildTriangle &BuildTri = BuildTriangles.AddDefaulted_GetRef();
+        FTriangle &Tri = BuildTri.Triangle;
+        Tri.A = Positions.VertexPosition(I0);
+        Tri.B = Positions.VertexPosition(I1);
+        Tri.C = Positions.VertexPosition(I2);
+        Tri.UVA = VertexData.GetVertexUV(I0, UVChannel);
+        Tri.UVB = VertexData.GetVertexUV(I1, UVChannel);
+        Tri.UVC = VertexData.GetVertexUV(I2, UVChannel);
+
+        // UE 使用顺时针绕序作为正面
+        Tri.Normal = FVector3f::CrossProduct(Tri.C - Tri.A, Tri.B - Tri.A).GetSafeNormal();
+
+        BuildTri.Centroid = (Tri.A + Tri.B + Tri.C) / 3.0f;
+    }
+
+    if (BuildTriangles.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FInkMeshUVData> Data = MakeShared<FInkMeshUVData>();
+    Data->Triangles.Reserve(BuildTriangles.Num());
+    Data->Nodes.Reserve(2 * BuildTriangles.Num() / MaxTrianglesPerLeaf + 1);
+    Data->Nodes.AddDefaulted();
+    Data->BuildNode(0, BuildTriangles, 0, BuildTriangles.Num(), 0);
+    Data->Bounds = Data->Nodes[0].Bounds;
+
+    UE_LOG(LogTemp, Log, TEXT("InkMeshUVData: Built BVH (%d triangles, %d nodes) for '%s'"),
+           Data->Triangles.Num(), Data->Nodes.Num(), *GetNameSafe(Mesh));
+
+    return Data;
+}
+
+void FInkMeshUVData::BuildNode(int32 NodeIndex, TArray<FBuildTriangle> &BuildTriangles, int32 First, int32 Count, int32 Depth)
+{
+    FBox3f NodeBounds(ForceInit);
+    FBox3f CentroidBounds(ForceInit);
+    for (int32 Index = First; Index < First + Count; ++Index)
+    {
+        const FBuildTriangle &BuildTri = BuildTriangles[Index];
+        NodeBounds += BuildTri.Triangle.A;
+        NodeBounds += BuildTri.Triangle.B;
+        NodeBounds += BuildTri.Triangle.C;
+        CentroidBounds += BuildTri.Centroid;
+    }
+    Nodes[NodeIndex].Bounds = NodeBounds;
+
+    // 叶节点：三角形按叶节点顺序追加，查询时连续访问
+    const FVector3f Extent = CentroidBounds.GetSize();
+    if (Count <= MaxTrianglesPerLeaf || Depth >= MaxDepth - 1 || Extent.GetMax() <= UE_KINDA_SMALL_NUMBER)
+    {
+        Nodes[NodeIndex].FirstIndex = Triangles.Num();
+        Nodes[NodeIndex].NumTriangles = Count;
+        for (int32 Index = First; Index < First + Count; ++Index)
+        {
+            Triangles.Add(BuildTriangles[Index].Triangle);
+        }
+        return;
+    }
+
+    // 沿质心包围盒最长轴在中位数处划分
+    const int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+    TArrayView<FBuildTriangle> Range(BuildTriangles.GetData() + First, Count);
+    Algo::Sort(Range, [Axis](const FBuildTriangle &L, const FBuildTriangle &R)
+               { return L.Centroid[Axis] < R.Centroid[Axis]; });
+
+    // 两个子节点相邻存放
+    const int32 ChildIndex = Nodes.AddDefaulted(2);
+    Nodes[NodeIndex].FirstIndex = ChildIndex;
+    Nodes[NodeIndex].NumTriangles = 0;
+
+    const int32 LeftCount = Count / 2;
+    BuildNode(ChildIndex, BuildTriangles, First, LeftCount, Depth + 1);
+    BuildNode(ChildIndex + 1, BuildTriangles, First + LeftCount, Count - LeftCount, Depth + 1);
+}
+
+bool FInkMeshUVData::ComputeUVDensity(const FVector3f &Scale3D, float &OutWorldArea, float &OutUVArea, float &OutAspect) const
+{
+    double WorldArea = 0.0;
+    double UVArea = 0.0;
+    double LengthU = 0.0;
+    double LengthV = 0.0;
+
+    for (const FTriangle &Tri : Triangles)
+    {
+        const FVector3f E1 = (Tri.B - Tri.A) * Scale3D;
+        const FVector3f E2 = (Tri.C - Tri.A) * Scale3D;
+        const FVector2f D1 = Tri.UVB - Tri.UVA;
+        const FVector2f D2 = Tri.UVC - Tri.UVA;
+
+        WorldArea += 0.5 * FVector3f::CrossProduct(E1, E2).Size();
+
+        const float Det = D1.X * D2.Y - D2.X * D1.Y;
+        const float TriUVArea = 0.5f * FMath::Abs(Det);
+        if (TriUVArea <= UE_SMALL_NUMBER)
+        {
+            // 退化的 UV 三角形
+            continue;
+        }
+        UVArea += TriUVArea;
+
+        // [E1 E2] = [dP/du dP/dv] * [D1 D2]，求每 UV 单位对应的世界长度
+        const float InvDet = 1.0f / Det;
+        const FVector3f PerU = (E1 * D2.Y - E2 * D1.Y) * InvDet;
+        const FVector3f PerV = (E2 * D1.X - E1 * D2.X) * InvDet;
+        LengthU += PerU.Size() * TriUVArea;
+        LengthV += PerV.Size() * TriUVArea;
+    }
+
+    OutWorldArea = static_cast<float>(WorldArea);
+    OutUVArea = static_cast<float>(UVArea);
+    OutAspect = (LengthU > 0.0 && LengthV > 0.0) ? static_cast<float>(LengthU / LengthV) : 1.0f;
+    return UVArea > UE_SMALL_NUMBER;
+}
+
+float FInkMeshUVData::ClosestPointBarycentric(const FVector3f &P, const FVector3f &A, const FVector3f &B, const FVector3f &C, FVector3f &OutBary)
+{
+    // Ericson, Real-Time Collision Detection 5.1.5
+    const FVector3f AB = B - A;
+    const FVector3f AC = C - A;
+    const FVector3f AP = P - A;
+
+    const float D1 = AB | AP;
+    const float D2 = AC | AP;
+    if (D1 <= 0.0f && D2 <= 0.0f)
+    {
+        OutBary = FVector3f(1.0f, 0.0f, 0.0f);
+        return (P - A).SizeSquared();
+    }
+
+    const FVector3f BP = P - B;
+    const float D3 = AB | BP;
+    const float D4 = AC | BP;
+    if (D3 >= 0.0f && D4 <= D3)
+    {
+        OutBary = FVector3f(0.0f, 1.0f, 0.0f);
+        return (P - B).SizeSquared();
+    }
+
+    const float VC = D1 * D4 - D3 * D2;
+    if (VC <= 0.0f && D1 >= 0.0f && D3 <= 0.0f)
+    {
+        const float V = D1 / (D1 - D3);
+        OutBary = FVector3f(1.0f - V, V, 0.0f);
+        return (P - (A + AB * V)).SizeSquared();
+    }
+
+    const FVector3f CP = P - C;
+    const float D5 = AB | CP;
+    const float D6 = AC | CP;
+    if (D6 >= 0.0f && D5 <= D6)
+    {
+        OutBary = FVector3f(0.0f, 0.0f, 1.0f);
+        return (P - C).SizeSquared();
+    }
+
+    const float VB = D5 * D2 - D1 * D6;
+    if (VB <= 0.0f && D2 >= 0.0f && D6 <= 0.0f)
+    {
+        const float W = D2 / (D2 - D6);
+        OutBary = FVector3f(1.0f - W, 0.0f, W);
+        return (P - (A + AC * W)).SizeSquared();
+    }
+
+    const float VA = D3 * D6 - D5 * D4;
+    if (VA <= 0.0f && (D4 - D3) >= 0.0f && (D5 - D6) >= 0.0f)
+    {
+        const float W = (D4 - D3) / ((D4 - D3) + (D5 - D6));
+        OutBary = FVector3f(0.0f, 1.0f - W, W);
+        return (P - (B + (C - B) * W)).SizeSquared();
+    }
+
+    const float Denom = 1.0f / (VA + VB + VC);
+    const float V = VB * Denom;
+    const float W = VC * Denom;
+    OutBary = FVector3f(1.0f - V - W, V, W);
+    return (P - (A + AB * V + AC * W)).SizeSquared();
+}
+
+bool FInkMeshUVData::FindUV(const FVector3f &LocalPoint, const FVector3f &LocalNormal, float MaxDistance, FVector2f &OutUV, float *OutDistance) const
+{
+    if (Nodes.IsEmpty())
+    {
+        return false;
+    }
+
+    const bool bFilterByNormal = !LocalNormal.IsNearlyZero();
+
+    float BestDistSq = MaxDistance * MaxDistance;
+    const FTriangle *BestTri = nullptr;
+    FVector3f BestBary;
+
+    // 最近点查询：按包围盒距离剪枝，优先访问更近的子节点
+    int32 Stack[MaxDepth * 2];
+    int32 StackSize = 0;
+    Stack[StackSize++] = 0;
+
+    while (StackSize > 0)
+    {
+        const FNode &Node = Nodes[Stack[--StackSize]];
+        if (Node.Bounds.ComputeSquaredDistanceToPoint(LocalPoint) > BestDistSq)
+        {
+            continue;
+        }
+
+        if (Node.NumTriangles == 0)
+        {
+            const int32 Left = Node.FirstIndex;
+            const int32 Right = Node.FirstIndex + 1;
+            const float LeftDistSq = Nodes[Left].Bounds.ComputeSquaredDistanceToPoint(LocalPoint);
+            const float RightDistSq = Nodes[Right].Bounds.ComputeSquaredDistanceToPoint(LocalPoint);
+
+            // 先压入较远的子节点
+            if (LeftDistSq <= RightDistSq)
+            {
+                Stack[StackSize++] = Right;
+                Stack[StackSize++] = Left;
+            }
+            else
+            {
+                Stack[StackSize++] = Left;
+                Stack[StackSize++] = Right;
+            }
+            continue;
+        }
+
+        for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumTriangles; ++Index)
+        {
+            const FTriangle &Tri = Triangles[Index];
+
+            // 忽略背对查询法线的三角形（例如墙的另一面）
+            if (bFilterByNormal && (Tri.Normal | LocalNormal) <= 0.0f)
+            {
+                continue;
+            }
+
+            FVector3f Bary;
+            const float DistSq = ClosestPointBarycentric(LocalPoint, Tri.A, Tri.B, Tri.C, Bary);
+            if (DistSq <= BestDistSq)
+            {
+                BestDistSq = DistSq;
+                BestTri = &Tri;
+                BestBary = Bary;
+            }
+        }
+    }
+
+    if (!BestTri)
+    {
+        return false;
+    }
+
+    OutUV = BestTri->UVA * BestBary.X + BestTri->UVB * BestBary.Y + BestTri->UVC * BestBary.Z;
+    if (OutDistance)
+    {
+        *OutDistance = FMath::Sqrt(BestDistSq);
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStaticMesh;
+
+/**
+ * 静态网格的局部空间三角形 + UV 通道数据，带三角形 BVH
+ * 每个网格资产只构建一次，由所有使用该网格的可涂色表面共享
+ * 用于把局部空间中的点直接映射到 UV，不需要物理射线检测，
+ * 也不依赖项目级的 "Support UV From Hit Results" 设置
+ */
+struct PROJECT2_API FInkMeshUVData
+{
+public:
+    /**
+     * 从网格 LOD0 渲染数据构建
+     * 打包版本中需要在网格资产上开启 "Allow CPU Access"，否则无法读取顶点数据
+     * @param Mesh			静态网格资产
+     * @param UVChannel		使用的 UV 通道（涂色使用 UV1）
+     * @return				构建失败时返回 nullptr
+     */
+    static TSharedPtr<const FInkMeshUVData> Build(UStaticMesh *Mesh, int32 UVChannel = 1);
+
+    /**
+     * 查找离局部空间点最近的三角形并插值出 UV
+     * @param LocalPoint	局部空间中的点
+     * @param LocalNormal	局部空间中的表面法线（零向量表示不按朝向过滤）
+     * @param MaxDistance	允许的最大距离（局部空间单位）
+     * @param OutUV			插值得到的 UV
+     * @param OutDistance	可选，点到三角形的距离
+     * @return				是否在 MaxDistance 内找到三角形
+     */
+    bool FindUV(const FVector3f &LocalPoint, const FVector3f &LocalNormal, float MaxDistance, FVector2f &OutUV, float *OutDistance = nullptr) const;
+
+    /**
+     * 统计网格在给定缩放下的表面积和 UV 覆盖面积，用于按墨水密度计算分辨率
+     * @param Scale3D		组件缩放
+     * @param OutWorldArea	世界空间表面积（cm²）
+     * @param OutUVArea		UV 空间覆盖面积（UV 单位正方形 = 1）
+     * @param OutAspect		U 方向与 V 方向每 UV 单位对应世界长度之比（按 UV 面积加权），用于非正方形分辨率
+     * @return				UV 面积为 0 时返回 false
+     */
+    bool ComputeUVDensity(const FVector3f &Scale3D, float &OutWorldArea, float &OutUVArea, float &OutAspect) const;
+
+    /** 三角形数量 */
+    int32 GetNumTriangles() const { return Triangles.Num(); }
+
+    /** 局部空间包围盒 */
+    const FBox3f &GetBounds() const { return Bounds; }
+
+    /** 占用的内存（字节） */
+    SIZE_T GetAllocatedSize() const { return Triangles.GetAllocatedSize() + Nodes.GetAllocatedSize(); }
+
+    /**
+     * 计算点在三角形上的最近点，以重心坐标返回
+     * @return	最近点到 P 的距离平方
+     */
+    static float ClosestPointBarycentric(const FVector3f &P, const FVector3f &A, const FVector3f &B, const FVector3f &C, FVector3f &OutBary);
+
+private:
+    struct FTriangle
+    {
+        FVector3f A, B, C;
+        FVector3f Normal;
+        FVector2f UVA, UVB, UVC;
+    };
+
+    /** BVH 节点：叶节点存三角形区间，内部节点的两个子节点相邻存放 */
+    struct FNode
+    {
+        FBox3f Bounds;
+
+        /** 叶节点：首个三角形下标；内部节点：左子节点下标（右子节点为 +1） */
+        int32 FirstIndex = 0;
+
+        /** 叶节点中的三角形数量，0 表示内部节点 */
+        int32 NumTriangles = 0;
+    };
+
+    /** 叶节点最多包含的三角形数量 */
+    static constexpr int32 MaxTrianglesPerLeaf = 4;
+
+    /** BVH 最大深度（查询栈大小） */
+    static constexpr int32 MaxDepth = 48;
+
+    /** 构建期使用的三角形（附带质心） */
+    struct FBuildTriangle
+    {
+        FTriangle Triangle;
+        FVector3f Centroid;
+    };
+
+    /** 递归填充 BVH 节点 */
+    void BuildNode(int32 NodeIndex, TArray<FBuildTriangle> &BuildTriangles, int32 First, int32 Count, int32 Depth);
+
+    /** 按 BVH 叶节点顺序排列的三角形 */
+    TArray<FTriangle> Triangles;
+
+    /** BVH 节点，0 为根节点 */
+    TArray<FNode> Nodes;
+
+    FBox3f Bounds = FBox3f(ForceInit);
+};
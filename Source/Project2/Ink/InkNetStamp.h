@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 网络同步用的量化画刷（8 字节）
+ *   uint16 SurfaceIndex	APaintManager::NetSurfaceIds 中的下标
+ *   uint16 U, V			与画刷日志相同的 16 位量化，服务器与客户端使用完全相同的 UV
+ *   uint16 TeamAndBrush	高 2 位为队伍编码，低 14 位为画刷日志的画刷大小（1/8 像素）原值
+ *
+ * 画刷大小不再二次量化，客户端与服务器、回放涂色完全相同的像素
+ */
+struct FInkNetStamp
+{
+    static constexpr int32 PackedSize = 8;
+
+    /** 可表示的最大画刷（日志单位 1/8 像素），PaintTarget 在记录前钳制到该值 */
+    static constexpr uint16 MaxJournalBrushSize = 0x3FFF;
+
+    /** 可表示的最大画刷（像素） */
+    static constexpr float MaxBrushSize = MaxJournalBrushSize / 8.0f;
+
+    uint16 SurfaceIndex = 0;
+    uint16 U = 0;
+    uint16 V = 0;
+    uint8 Team = 0;
+
+    /** 画刷大小，与 FInkJournalEntry::BrushSize 相同的 1/8 像素单位 */
+    uint16 BrushSize = 0;
+
+    float GetBrushSize() const { return BrushSize / 8.0f; }
+
+    FVector2D GetUV() const { return FVector2D(U / 65535.0, V / 65535.0); }
+
+    void Pack(TArray<uint8> &Out) const
+    {
+        const uint16 TeamAndBrush = static_cast<uint16>(((Team & 0x3) << 14) | FMath::Min(BrushSize, MaxJournalBrushSize));
+
+        uint8 *Dest = Out.GetData() + Out.AddUninitialized(PackedSize);
+        Dest[0] = static_cast<uint8>(SurfaceIndex);
+        Dest[1] = static_cast<uint8>(SurfaceIndex >> 8);
+        Dest[2] = static_cast<uint8>(U);
+        Dest[3] = static_cast<uint8>(U >> 8);
+        Dest[4] = static_cast<uint8>(V);
+        Dest[5] = static_cast<uint8>(V >> 8);
+        Dest[6] = static_cast<uint8>(TeamAndBrush);
+        Dest[7] = static_cast<uint8>(TeamAndBrush >> 8);
+    }
+
+    static FInkNetStamp Unpack(const uint8 *Src)
+    {
+        const uint16 TeamAndBrush = static_cast<uint16>(Src[6] | (Src[7] << 8));
+
+        FInkNetStamp Stamp;
+        Stamp.SurfaceIndex = static_cast<uint16>(Src[0] | (Src[1] << 8));
+        Stamp.U = static_cast<uint16>(Src[2] | (Src[3] << 8));
+        Stamp.V = static_cast<uint16>(Src[4] | (Src[5] << 8));
+        Stamp.Team = static_cast<uint8>(TeamAndBrush >> 14);
+        Stamp.BrushSize = TeamAndBrush & MaxJournalBrushSize;
+        return Stamp;
+    }
+};
+
+/**
+ * 以一秒为窗口的字节计数，用于统计每个连接的同步流量
+ */
+struct FInkNetRateCounter
+{
+    int64 TotalBytes = 0;
+
+    void Add(int32 Bytes, double Now)
+    {
+        Advance(Now);
+        WindowBytes += Bytes;
+        TotalBytes += Bytes;
+    }
+
+    /** 上一个完整窗口的字节 / 秒；超过两个窗口没有流量时为 0 */
+    float GetBytesPerSecond(double Now) const
+    {
+        return Now - WindowStart < 2.0 ? BytesPerSecond : 0.0f;
+    }
+
+    void Advance(double Now)
+    {
+        const double Elapsed = Now - WindowStart;
+        if (Elapsed >= 1.0)
+        {
+            BytesPerSecond = Elapsed < 2.0 ? static_cast<float>(WindowBytes / Elapsed) : 0.0f;
+            WindowBytes = 0;
+            WindowStart = Now;
+        }
+    }
+
+private:
+    double WindowStart = 0.0;
+    int64 WindowBytes = 0;
+    float BytesPerSecond = 0.0f;
+};
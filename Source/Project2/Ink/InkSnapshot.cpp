@@ -0,0 +1,415 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkSnapshot.h"
+#include "InkSystemComponent.h"
+#include "InkWorldSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Ink snapshot format assumes a little-endian platform.");
+
+namespace InkSnapshot
+{
+    enum EWordOp : uint32
+    {
+        Op_Zeros = 0,
+        Op_Ones = 1,
+        Op_Literal = 2,
+    };
+
+    /** 快照中宽高 / 行数的上限，防止损坏的数据导致超大分配 */
+    constexpr uint32 MaxDimension = 16384;
+
+    void WriteBytes(TArray<uint8> &Out, const void *Data, int32 Size)
+    {
+        const int32 Offset = Out.AddUninitialized(Size);
+        FMemory::Memcpy(Out.GetData() + Offset, Data, Size);
+    }
+
+    template <typename T>
+    void WritePod(TArray<uint8> &Out, T Value)
+    {
+        WriteBytes(Out, &Value, sizeof(T));
+    }
+
+    void WriteVarInt(TArray<uint8> &Out, uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Out.Add(static_cast<uint8>(Value | 0x80));
+            Value >>= 7;
+        }
+        Out.Add(static_cast<uint8>(Value));
+    }
+
+    /** 按全零 / 全一 / 原样三类对连续字做游程编码 */
+    void WriteWords(TArray<uint8> &Out, TConstArrayView<uint64> Words)
+    {
+        auto Classify = [](uint64 Word)
+        {
+            return Word == 0 ? Op_Zeros : (Word == ~0ull ? Op_Ones : Op_Literal);
+        };
+
+        int32 Index = 0;
+        while (Index < Words.Num())
+        {
+            const EWordOp Op = Classify(Words[Index]);
+            int32 End = Index + 1;
+            while (End < Words.Num() && Classify(Words[End]) == Op)
+            {
+                ++End;
+            }
+
+            const uint32 Count = static_cast<uint32>(End - Index);
+            WriteVarInt(Out, (Count << 2) | Op);
+            if (Op == Op_Literal)
+            {
+                WriteBytes(Out, Words.GetData() + Index, Count * sizeof(uint64));
+            }
+            Index = End;
+        }
+    }
+
+    /** 带越界检查的读取器 */
+    struct FReader
+    {
+        TConstArrayView<uint8> Data;
+        int32 Offset = 0;
+        bool bError = false;
+
+        bool ReadBytes(void *Dest, int32 Size)
+        {
+            if (bError || Offset + Size > Data.Num())
+            {
+                bError = true;
+                return false;
+            }
+            FMemory::Memcpy(Dest, Data.GetData() + Offset, Size);
+            Offset += Size;
+            return true;
+        }
+
+        template <typename T>
+        T ReadPod()
+        {
+            T Value{};
+            ReadBytes(&Value, sizeof(T));
+            return Value;
+        }
+
+        uint32 ReadVarInt()
+        {
+            uint32 Value = 0;
+            for (int32 Shift = 0; Shift < 35; Shift += 7)
+            {
+                uint8 Byte = 0;
+                if (!ReadBytes(&Byte, 1))
+                {
+                    return 0;
+                }
+                Value |= static_cast<uint32>(Byte & 0x7F) << Shift;
+                if (!(Byte & 0x80))
+                {
+                    return Value;
+                }
+            }
+            bError = true;
+            return 0;
+        }
+
+        /** 解码恰好 OutWords.Num() 个字 */
+        bool ReadWords(TArrayView<uint64> OutWords)
+        {
+            int32 Index = 0;
+            while (Index < OutWords.Num() && !bError)
+            {
+                const uint32 Token = ReadVarInt();
+                const uint32 Op = Token & 3;
+                const int32 Count = static_cast<int32>(Token >> 2);
+                if (Count <= 0 || Count > OutWords.Num() - Index)
+                {
+                    bError = true;
+                    break;
+                }
+
+                switch (Op)
+                {
+                case Op_Zeros:
+                    FMemory::Memzero(OutWords.GetData() + Index, Count * sizeof(uint64));
+                    break;
+                case Op_Ones:
+                    FMemory::Memset(OutWords.GetData() + Index, 0xFF, Count * sizeof(uint64));
+                    break;
+                case Op_Literal:
+                    ReadBytes(OutWords.GetData() + Index, Count * sizeof(uint64));
+                    break;
+                default:
+                    bError = true;
+                    break;
+                }
+                Index += Count;
+            }
+            return !bError;
+        }
+    };
+}
+
+FInkSnapshotWriter::FInkSnapshotWriter(TConstArrayView<UInkSystemComponent *> InSurfaces, const FInkSnapshotBase *InBase)
+{
+    Surfaces.Reserve(InSurfaces.Num());
+    for (UInkSystemComponent *Surface : InSurfaces)
+    {
+        Surfaces.Add(Surface);
+    }
+
+    if (InBase)
+    {
+        Base = *InBase;
+        bIsDelta = true;
+    }
+}
+
+bool FInkSnapshotWriter::WriteChunk(TArray<uint8> &OutChunk, int32 MaxChunkBytes)
+{
+    using namespace InkSnapshot;
+
+    OutChunk.Reset();
+    WritePod<uint32>(OutChunk, FInkSnapshot::Magic);
+    WritePod<uint16>(OutChunk, FInkSnapshot::Version);
+    WritePod<uint8>(OutChunk, static_cast<uint8>(bIsDelta ? FInkSnapshot::EKind::Delta : FInkSnapshot::EKind::Full));
+    WritePod<uint8>(OutChunk, static_cast<uint8>(InkMaxTeams));
+
+    // 表面数量在写完后回填
+    const int32 CountOffset = OutChunk.Num();
+    WritePod<uint32>(OutChunk, 0);
+
+    uint32 NumWritten = 0;
+    while (NextSurface < Surfaces.Num())
+    {
+        UInkSystemComponent *Surface = Surfaces[NextSurface++].Get();
+        if (Surface && WriteSurface(*Surface, OutChunk))
+        {
+            ++NumWritten;
+            if (OutChunk.Num() >= MaxChunkBytes)
+            {
+                break;
+            }
+        }
+    }
+
+    FMemory::Memcpy(OutChunk.GetData() + CountOffset, &NumWritten, sizeof(uint32));
+    return !IsDone();
+}
+
+bool FInkSnapshotWriter::WriteSurface(UInkSystemComponent &Surface, TArray<uint8> &Out)
+{
+    using namespace InkSnapshot;
+
+    const FInkCoverageGrid &Grid = Surface.GetCoverageGrid();
+    if (!Grid.IsValid())
+    {
+        return false;
+    }
+
+    const uint32 SurfaceId = Surface.GetSurfaceId();
+    const uint32 *BaseRevision = bIsDelta ? Base.RevisionBySurface.Find(SurfaceId) : nullptr;
+
+    // 收集需要写入的行区间：基准中没有的表面写入全部行
+    TArray<TPair<int32, int32>, TInlineAllocator<16>> Spans;
+    if (!BaseRevision)
+    {
+        Spans.Emplace(0, Grid.GetHeight());
+    }
+    else
+    {
+        for (int32 Y = 0; Y < Grid.GetHeight(); ++Y)
+        {
+            if (Grid.GetRowRevision(Y) <= *BaseRevision)
+            {
+                continue;
+            }
+
+            if (!Spans.IsEmpty() && Spans.Last().Key + Spans.Last().Value == Y)
+            {
+                ++Spans.Last().Value;
+            }
+            else
+            {
+                Spans.Emplace(Y, 1);
+            }
+        }
+    }
+
+    const uint32 Revision = Surface.CaptureCoverageRevision();
+    CapturedBase.RevisionBySurface.Add(SurfaceId, Revision);
+
+    if (Spans.IsEmpty())
+    {
+        return false;
+    }
+
+    WritePod<uint32>(Out, SurfaceId);
+    WritePod<uint32>(Out, Revision);
+    WriteVarInt(Out, Grid.GetWidth());
+    WriteVarInt(Out, Grid.GetHeight());
+    WriteVarInt(Out, Spans.Num());
+
+    for (const TPair<int32, int32> &Span : Spans)
+    {
+        WriteVarInt(Out, Span.Key);
+        WriteVarInt(Out, Span.Value);
+        for (int32 Team = 1; Team <= InkMaxTeams; ++Team)
+        {
+            WriteWords(Out, Grid.GetPlaneRows(static_cast<uint8>(Team), Span.Key, Span.Value));
+        }
+    }
+
+    return true;
+}
+
+bool FInkSnapshot::Apply(TConstArrayView<uint8> Chunk, UInkWorldSubsystem &Subsystem, FInkSnapshotBase *OutBase)
+{
+    using namespace InkSnapshot;
+
+    FReader Reader{Chunk};
+    const uint32 ChunkMagic = Reader.ReadPod<uint32>();
+    const uint16 ChunkVersion = Reader.ReadPod<uint16>();
+    Reader.ReadPod<uint8>(); // Kind：完整与增量使用相同的表面结构
+    const uint8 NumTeams = Reader.ReadPod<uint8>();
+    const uint32 NumSurfaces = Reader.ReadPod<uint32>();
+
+    if (Reader.bError || ChunkMagic != Magic || ChunkVersion != Version || NumTeams != InkMaxTeams)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkSnapshot: Invalid chunk header (magic %08x, version %d, teams %d)."),
+               ChunkMagic, ChunkVersion, NumTeams);
+        return false;
+    }
+
+    TArray<uint64> Words;
+    for (uint32 SurfaceIndex = 0; SurfaceIndex < NumSurfaces && !Reader.bError; ++SurfaceIndex)
+    {
+        const uint32 SurfaceId = Reader.ReadPod<uint32>();
+        const uint32 Revision = Reader.ReadPod<uint32>();
+        const uint32 Width = Reader.ReadVarInt();
+        const uint32 Height = Reader.ReadVarInt();
+        const uint32 NumSpans = Reader.ReadVarInt();
+        if (Width == 0 || Width > MaxDimension || Height == 0 || Height > MaxDimension)
+        {
+            Reader.bError = true;
+            break;
+        }
+
+        // 尺寸不一致（例如分辨率设置不同）时仍需解码以跳过数据
+        UInkSystemComponent *Surface = Subsystem.FindSurfaceById(SurfaceId);
+        const FInkCoverageGrid *Grid = Surface ? &Surface->GetCoverageGrid() : nullptr;
+        if (Surface && (Grid->GetWidth() != static_cast<int32>(Width) || Grid->GetHeight() != static_cast<int32>(Height)))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("InkSnapshot: Surface %08x is %dx%d locally but %ux%u in snapshot, skipped."),
+                   SurfaceId, Grid->GetWidth(), Grid->GetHeight(), Width, Height);
+            Surface = nullptr;
+        }
+
+        const int32 WordsPerRow = static_cast<int32>((Width + 63) / 64);
+        for (uint32 SpanIndex = 0; SpanIndex < NumSpans && !Reader.bError; ++SpanIndex)
+        {
+            const uint32 FirstRow = Reader.ReadVarInt();
+            const uint32 NumRows = Reader.ReadVarInt();
+            if (NumRows == 0 || FirstRow + NumRows > Height)
+            {
+                Reader.bError = true;
+                break;
+            }
+
+            Words.SetNumUninitialized(NumRows * WordsPerRow);
+            for (int32 Team = 1; Team <= InkMaxTeams; ++Team)
+            {
+                if (!Reader.ReadWords(Words))
+                {
+                    break;
+                }
+
+                if (Surface)
+                {
+                    Surface->ApplyCoverageRows(static_cast<uint8>(Team), FirstRow, Words);
+                }
+            }
+        }
+
+        if (Surface && !Reader.bError)
+        {
+            Surface->RefreshInkFromCoverage();
+            if (OutBase)
+            {
+                OutBase->RevisionBySurface.Add(SurfaceId, Revision);
+            }
+        }
+    }
+
+    if (Reader.bError)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkSnapshot: Truncated or corrupt chunk (%d bytes)."), Chunk.Num());
+        return false;
+    }
+
+    return true;
+}
+
+// ========== 控制台命令 ==========
+
+static FString GetInkSnapshotPath(const TArray<FString> &Args)
+{
+    const FString FileName = Args.Num() > 0 ? Args[0] : TEXT("InkSnapshot.bin");
+    return FPaths::IsRelative(FileName) ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Ink"), FileName) : FileName;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GInkSnapshotSaveCommand(
+    TEXT("ink.Snapshot.Save"),
+    TEXT("Writes a full ink snapshot of all surfaces. Usage: ink.Snapshot.Save [File]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString> &Args, UWorld *World)
+    {
+        UInkWorldSubsystem *Subsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(World);
+        if (!Subsystem)
+        {
+            return;
+        }
+
+        TArray<UInkSystemComponent *> Surfaces;
+        Subsystem->GetRegisteredSurfaces(Surfaces);
+
+        TArray<uint8> Data;
+        FInkSnapshotWriter Writer(Surfaces);
+        Writer.WriteChunk(Data);
+
+        const FString Path = GetInkSnapshotPath(Args);
+        if (FFileHelper::SaveArrayToFile(Data, *Path))
+        {
+            UE_LOG(LogTemp, Log, TEXT("InkSnapshot: Saved %d surfaces (%d bytes) to '%s'"), Surfaces.Num(), Data.Num(), *Path);
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs GInkSnapshotLoadCommand(
+    TEXT("ink.Snapshot.Load"),
+    TEXT("Applies an ink snapshot file to the current world. Usage: ink.Snapshot.Load [File]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString> &Args, UWorld *World)
+    {
+        UInkWorldSubsystem *Subsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(World);
+        if (!Subsystem)
+        {
+            return;
+        }
+
+        TArray<uint8> Data;
+        const FString Path = GetInkSnapshotPath(Args);
+        if (!FFileHelper::LoadFileToArray(Data, *Path))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("InkSnapshot: Cannot read '%s'"), *Path);
+            return;
+        }
+
+        if (FInkSnapshot::Apply(Data, *Subsystem))
+        {
+            UE_LOG(LogTemp, Log, TEXT("InkSnapshot: Applied '%s' (%d bytes)"), *Path, Data.Num());
+        }
+    }));
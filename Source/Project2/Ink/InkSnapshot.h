@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UInkSystemComponent;
+class UInkWorldSubsystem;
+
+/**
+ * 快照基准：记录每个表面被写入快照时的归属网格修订号
+ * 生成增量时只写入修订号大于基准的行
+ */
+struct FInkSnapshotBase
+{
+    /** 表面 ID -> 修订号 */
+    TMap<uint32, uint32> RevisionBySurface;
+};
+
+/**
+ * 墨水快照二进制格式（小端）
+ *
+ *   块头：uint32 Magic ('INKS')，uint16 Version，uint8 Kind（0 = 完整，1 = 增量），uint8 NumTeams，uint32 NumSurfaces
+ *   表面：uint32 SurfaceId，uint32 Revision，varint Width，varint Height，varint NumSpans
+ *   行区间：varint FirstRow，varint NumRows，随后依次为 NumTeams 个位平面的字流
+ *   字流：若干个 varint((Count << 2) | Op)
+ *         Op 0 = Count 个全零字，Op 1 = Count 个全一字，Op 2 = 其后紧跟 Count 个原样 uint64
+ *
+ * 空白和大片涂满的区域只占几个字节；每个数据块都带完整块头，可以单独传输和应用
+ */
+struct PROJECT2_API FInkSnapshot
+{
+    static constexpr uint32 Magic = 0x534B4E49;
+    static constexpr uint16 Version = 1;
+
+    /** 块头字节数；不含任何表面的块只有块头 */
+    static constexpr int32 HeaderSize = 12;
+
+    enum class EKind : uint8
+    {
+        Full = 0,
+        Delta = 1,
+    };
+
+    /**
+     * 应用一个快照数据块：完整表面直接替换，增量只覆盖其中的行
+     * 领地统计同步更新；已分配 GPU 存储的表面立即刷新，其余表面在可见时恢复
+     * @param Chunk			数据块
+     * @param Subsystem		按表面 ID 查找目标表面
+     * @param OutBase		可选，记录块中各表面的修订号（客户端据此请求后续增量）
+     * @return				数据块格式有效（未知的表面会被跳过）
+     */
+    static bool Apply(TConstArrayView<uint8> Chunk, UInkWorldSubsystem &Subsystem, FInkSnapshotBase *OutBase = nullptr);
+};
+
+/**
+ * 快照写入器，按块输出，可跨帧流式发送
+ * 每个表面在被写入时记录修订号，因此跨帧期间的修改会在下一次增量中发送
+ */
+class PROJECT2_API FInkSnapshotWriter
+{
+public:
+    /**
+     * @param InSurfaces	要写入的表面
+     * @param InBase		可选，增量基准；基准中没有的表面写入完整数据
+     */
+    FInkSnapshotWriter(TConstArrayView<UInkSystemComponent *> InSurfaces, const FInkSnapshotBase *InBase = nullptr);
+
+    /**
+     * 写出下一个数据块；块中至少包含一个表面，因此可能超过 MaxChunkBytes
+     * @return	是否还有未写出的表面
+     */
+    bool WriteChunk(TArray<uint8> &OutChunk, int32 MaxChunkBytes = MAX_int32);
+
+    /** 是否已写完所有表面 */
+    bool IsDone() const { return NextSurface >= Surfaces.Num(); }
+
+    /** 已写出表面的修订号，作为下一次增量的基准 */
+    const FInkSnapshotBase &GetCapturedBase() const { return CapturedBase; }
+
+private:
+    /** 写入单个表面，增量中没有修改的表面不写入，返回是否写入 */
+    bool WriteSurface(UInkSystemComponent &Surface, TArray<uint8> &Out);
+
+    TArray<TWeakObjectPtr<UInkSystemComponent>> Surfaces;
+    FInkSnapshotBase Base;
+    bool bIsDelta = false;
+    int32 NextSurface = 0;
+    FInkSnapshotBase CapturedBase;
+};
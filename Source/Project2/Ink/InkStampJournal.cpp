@@ -0,0 +1,139 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkStampJournal.h"
+#include "InkWorldSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+void FInkStampJournal::SetCapacity(int32 InCapacity)
+{
+    Entries.Reset();
+    Entries.SetNumZeroed(FMath::Max(InCapacity, 0));
+    Reset();
+}
+
+void FInkStampJournal::Reset()
+{
+    Head = 0;
+    Count = 0;
+    TotalRecorded = 0;
+}
+
+void FInkStampJournal::CopyEntries(TArray<FInkJournalEntry> &OutEntries, float SinceServerTime) const
+{
+    OutEntries.Reset(Count);
+
+    // 最旧的条目位于 Head - Count
+    const int32 Capacity = Entries.Num();
+    const int32 First = (Head - Count + Capacity) % FMath::Max(Capacity, 1);
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const FInkJournalEntry &Entry = Entries[(First + Index) % Capacity];
+        if (SinceServerTime < 0.0f || Entry.ServerTime >= SinceServerTime)
+        {
+            OutEntries.Add(Entry);
+        }
+    }
+}
+
+bool FInkStampJournal::SaveToFile(const FString &Path) const
+{
+    TArray<FInkJournalEntry> Ordered;
+    CopyEntries(Ordered);
+
+    // 文件头：Magic，Version，条目数；随后为条目数组
+    const uint32 NumEntries = Ordered.Num();
+    TArray<uint8> Data;
+    Data.Reserve(sizeof(uint32) * 2 + sizeof(uint16) + Ordered.Num() * sizeof(FInkJournalEntry));
+    Data.Append(reinterpret_cast<const uint8 *>(&FileMagic), sizeof(uint32));
+    Data.Append(reinterpret_cast<const uint8 *>(&FileVersion), sizeof(uint16));
+    Data.Append(reinterpret_cast<const uint8 *>(&NumEntries), sizeof(uint32));
+    Data.Append(reinterpret_cast<const uint8 *>(Ordered.GetData()), Ordered.Num() * sizeof(FInkJournalEntry));
+
+    return FFileHelper::SaveArrayToFile(Data, *Path);
+}
+
+bool FInkStampJournal::LoadFromFile(const FString &Path, TArray<FInkJournalEntry> &OutEntries)
+{
+    OutEntries.Reset();
+
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Path))
+    {
+        return false;
+    }
+
+    constexpr int32 HeaderSize = sizeof(uint32) * 2 + sizeof(uint16);
+    if (Data.Num() < HeaderSize)
+    {
+        return false;
+    }
+
+    uint32 Magic = 0;
+    uint16 Version = 0;
+    uint32 NumEntries = 0;
+    FMemory::Memcpy(&Magic, Data.GetData(), sizeof(uint32));
+    FMemory::Memcpy(&Version, Data.GetData() + sizeof(uint32), sizeof(uint16));
+    FMemory::Memcpy(&NumEntries, Data.GetData() + sizeof(uint32) + sizeof(uint16), sizeof(uint32));
+
+    if (Magic != FileMagic || Version != FileVersion || static_cast<int64>(NumEntries) * sizeof(FInkJournalEntry) != Data.Num() - HeaderSize)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkStampJournal: '%s' is not a valid journal file."), *Path);
+        return false;
+    }
+
+    OutEntries.SetNumUninitialized(NumEntries);
+    FMemory::Memcpy(OutEntries.GetData(), Data.GetData() + HeaderSize, NumEntries * sizeof(FInkJournalEntry));
+    return true;
+}
+
+// ========== 控制台命令 ==========
+
+static FString GetInkJournalPath(const TArray<FString> &Args)
+{
+    const FString FileName = Args.Num() > 0 ? Args[0] : TEXT("InkJournal.bin");
+    return FPaths::IsRelative(FileName) ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Ink"), FileName) : FileName;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GInkJournalSaveCommand(
+    TEXT("ink.Journal.Save"),
+    TEXT("Writes the paint stamp journal to disk. Usage: ink.Journal.Save [File]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString> &Args, UWorld *World)
+    {
+        const UInkWorldSubsystem *Subsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(World);
+        if (!Subsystem)
+        {
+            return;
+        }
+
+        const FString Path = GetInkJournalPath(Args);
+        if (Subsystem->GetStampJournal().SaveToFile(Path))
+        {
+            UE_LOG(LogTemp, Log, TEXT("InkStampJournal: Saved %d entries to '%s'"), Subsystem->GetStampJournal().Num(), *Path);
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs GInkJournalReplayCommand(
+    TEXT("ink.Journal.Replay"),
+    TEXT("Clears all surfaces and replays a journal file. Usage: ink.Journal.Replay [File] [KeepInk=0]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString> &Args, UWorld *World)
+    {
+        UInkWorldSubsystem *Subsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(World);
+        if (!Subsystem)
+        {
+            return;
+        }
+
+        TArray<FInkJournalEntry> Entries;
+        const FString Path = GetInkJournalPath(Args);
+        if (!FInkStampJournal::LoadFromFile(Path, Entries))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("InkStampJournal: Cannot read '%s'"), *Path);
+            return;
+        }
+
+        const bool bKeepInk = Args.Num() > 1 && FCString::Atoi(*Args[1]) != 0;
+        Subsystem->ReplayJournal(Entries, !bKeepInk);
+    }));
@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 画刷日志条目（16 字节 POD，直接按内存布局写入文件）
+ * UV 和画刷大小在记录前量化，实际涂色也使用量化后的值，保证回放结果与现场一致
+ */
+struct FInkJournalEntry
+{
+    /** 表面 ID（见 UInkSystemComponent::GetSurfaceId） */
+    uint32 SurfaceId = 0;
+
+    /** UV 量化到 16 位（0-65535 对应 0-1） */
+    uint16 U = 0;
+    uint16 V = 0;
+
+    /** 队伍编码（E_Team 底层值） */
+    uint8 Team = 0;
+
+    uint8 Padding = 0;
+
+    /** 画刷大小，单位 1/8 像素 */
+    uint16 BrushSize = 0;
+
+    /** 服务器时间（秒） */
+    float ServerTime = 0.0f;
+
+    /** 由原始参数构造并量化 */
+    static FInkJournalEntry Make(uint32 InSurfaceId, const FVector2D &InUV, uint8 InTeam, float InBrushSize, float InServerTime)
+    {
+        FInkJournalEntry Entry;
+        Entry.SurfaceId = InSurfaceId;
+        Entry.U = static_cast<uint16>(FMath::RoundToInt32(FMath::Clamp(InUV.X, 0.0, 1.0) * 65535.0));
+        Entry.V = static_cast<uint16>(FMath::RoundToInt32(FMath::Clamp(InUV.Y, 0.0, 1.0) * 65535.0));
+        Entry.Team = InTeam;
+        Entry.BrushSize = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(InBrushSize * 8.0f), 0, 65535));
+        Entry.ServerTime = InServerTime;
+        return Entry;
+    }
+
+    /** 量化后的 UV */
+    FVector2D GetUV() const { return FVector2D(U / 65535.0, V / 65535.0); }
+
+    /** 量化后的画刷大小（像素） */
+    float GetBrushSize() const { return BrushSize / 8.0f; }
+};
+
+static_assert(sizeof(FInkJournalEntry) == 16, "FInkJournalEntry is written to disk as-is.");
+
+/**
+ * 定长环形画刷日志
+ * 记录每一次 PaintTarget，写满后覆盖最旧的条目
+ * 可保存到文件离线复现问题，或为观战 / 击杀回放提供近期涂色
+ */
+class PROJECT2_API FInkStampJournal
+{
+public:
+    static constexpr uint32 FileMagic = 0x4A4B4E49; // 'INKJ'
+    static constexpr uint16 FileVersion = 1;
+
+    /** 设置容量并清空（0 表示停用） */
+    void SetCapacity(int32 InCapacity);
+
+    /** 追加一条记录 */
+    void Record(const FInkJournalEntry &Entry)
+    {
+        if (Entries.Num() == 0)
+        {
+            return;
+        }
+
+        Entries[Head] = Entry;
+        Head = (Head + 1) % Entries.Num();
+        Count = FMath::Min(Count + 1, Entries.Num());
+        ++TotalRecorded;
+    }
+
+    /** 清空 */
+    void Reset();
+
+    /** 是否启用 */
+    bool IsEnabled() const { return Entries.Num() > 0; }
+
+    /** 当前保存的条目数量 */
+    int32 Num() const { return Count; }
+
+    /** 自启用以来记录的总条目数（包括被覆盖的） */
+    uint64 GetTotalRecorded() const { return TotalRecorded; }
+
+    /**
+     * 按时间顺序复制条目
+     * @param OutEntries		输出
+     * @param SinceServerTime	只复制不早于该时间的条目，负数表示全部
+     */
+    void CopyEntries(TArray<FInkJournalEntry> &OutEntries, float SinceServerTime = -1.0f) const;
+
+    /** 按时间顺序写入文件 */
+    bool SaveToFile(const FString &Path) const;
+
+    /** 从文件读取条目（按时间顺序） */
+    static bool LoadFromFile(const FString &Path, TArray<FInkJournalEntry> &OutEntries);
+
+private:
+    TArray<FInkJournalEntry> Entries;
+
+    /** 下一条写入的位置 */
+    int32 Head = 0;
+
+    /** 有效条目数 */
+    int32 Count = 0;
+
+    uint64 TotalRecorded = 0;
+};
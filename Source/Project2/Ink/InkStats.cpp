@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkStats.h"
+#include "InkStampJournal.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_STAT(STAT_InkTrace);
+DEFINE_STAT(STAT_InkUVLookup);
+DEFINE_STAT(STAT_InkSplat);
+DEFINE_STAT(STAT_InkStampQueue);
+DEFINE_STAT(STAT_InkCoverageRaster);
+DEFINE_STAT(STAT_InkFlush);
+DEFINE_STAT(STAT_InkNetSend);
+DEFINE_STAT(STAT_InkDecay);
+
+DEFINE_STAT(STAT_InkStampsPerFrame);
+DEFINE_STAT(STAT_InkSurfacesPainted);
+DEFINE_STAT(STAT_InkLiveProjectiles);
+DEFINE_STAT(STAT_InkStorageMemory);
+
+CSV_DEFINE_CATEGORY_MODULE(PROJECT2_API, Ink, true);
+
+UE_TRACE_CHANNEL_DEFINE(InkChannel);
+
+UE_TRACE_EVENT_BEGIN(Ink, Stamp)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, SurfaceId)
+    UE_TRACE_EVENT_FIELD(float, U)
+    UE_TRACE_EVENT_FIELD(float, V)
+    UE_TRACE_EVENT_FIELD(float, BrushSize)
+    UE_TRACE_EVENT_FIELD(uint8, Team)
+UE_TRACE_EVENT_END()
+
+namespace InkStats
+{
+    int32 LiveProjectiles = 0;
+
+    void TraceStamp(const FInkJournalEntry &Entry)
+    {
+        UE_TRACE_LOG(Ink, Stamp, InkChannel)
+            << Stamp.Cycle(FPlatformTime::Cycles64())
+            << Stamp.SurfaceId(Entry.SurfaceId)
+            << Stamp.U(static_cast<float>(Entry.GetUV().X))
+            << Stamp.V(static_cast<float>(Entry.GetUV().Y))
+            << Stamp.BrushSize(Entry.GetBrushSize())
+            << Stamp.Team(Entry.Team);
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+struct FInkJournalEntry;
+
+/**
+ * 墨水系统的性能统计
+ *
+ * - stat Ink：涂色路径各阶段的耗时和每帧计数
+ * - CSV 分析器（csvprofile start）：Ink 分类下的每帧画刷数、存活投射物、墨水显存和被涂色的表面数
+ * - Unreal Insights（-trace=ink）：每个画刷一条 Ink.Stamp 事件
+ */
+DECLARE_STATS_GROUP(TEXT("Ink"), STATGROUP_Ink, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trace (Hit To Paint)"), STAT_InkTrace, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UV Lookup"), STAT_InkUVLookup, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sphere Splat"), STAT_InkSplat, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Stamp Queue"), STAT_InkStampQueue, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Coverage Raster"), STAT_InkCoverageRaster, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flush"), STAT_InkFlush, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Send"), STAT_InkNetSend, STATGROUP_Ink, PROJECT2_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Decay"), STAT_InkDecay, STATGROUP_Ink, PROJECT2_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Stamps / Frame"), STAT_InkStampsPerFrame, STATGROUP_Ink, PROJECT2_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Surfaces Painted / Frame"), STAT_InkSurfacesPainted, STATGROUP_Ink, PROJECT2_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Projectiles"), STAT_InkLiveProjectiles, STATGROUP_Ink, PROJECT2_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Ink Storage"), STAT_InkStorageMemory, STATGROUP_Ink, PROJECT2_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(PROJECT2_API, Ink);
+
+UE_TRACE_CHANNEL_EXTERN(InkChannel, PROJECT2_API);
+
+namespace InkStats
+{
+    /** 当前存活的投射物数量（由 AShooterProjectile 维护） */
+    extern PROJECT2_API int32 LiveProjectiles;
+
+    /** 向 Insights 的 Ink 通道写入一条画刷事件（通道未开启时几乎无开销） */
+    PROJECT2_API void TraceStamp(const FInkJournalEntry &Entry);
+}
@@ -1,8 +1,14 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "InkSystemComponent.h"
+#include "InkWorldSubsystem.h"
+#include "InkStats.h"
+#include "InkMeshUVData.h"
+#include "Engine/World.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "Engine/Texture2D.h"
+#include "Engine/Canvas.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Kismet/KismetRenderingLibrary.h"
 
@@ -28,20 +34,478 @@ void UInkSystemComponent::BeginPlay()
         return;
     }
 
-    // 初始化 Render Target 和动态材质
+    // 去除 PIE 前缀，使服务器与客户端得到相同的 ID（运行时生成的表面不保证一致）
+    SurfaceId = FCrc::StrCrc32(*UWorld::RemovePIEPrefix(GetPathName()));
+
+    // 网格 UV 数据由子系统缓存，需先获取子系统
+    InkSubsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(GetWorld());
+    if (InkSubsystem.IsValid())
+    {
+        TextureEncoding = InkSubsystem->GetInkTextureEncoding();
+    }
+
+    // 确定分辨率，再初始化 CPU 归属网格（不依赖 RHI，-nullrhi 下同样可用）
+    InitializeResolution();
+    InitializeCoverageGrid();
+
+    // 记录原材质，GPU 存储在首次涂色时才分配（见 EnsureInkStorage）
+    OriginalMaterial = CachedMeshComponent->GetMaterial(MaterialSlotIndex);
+
+    // 注册到墨水子系统，命中时按网格组件直接查找
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->RegisterSurface(this, CachedMeshComponent);
+    }
+}
+
+void UInkSystemComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // 归还图集区域
+    ReleaseInkStorage();
+
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->UnregisterSurface(this);
+        InkSubsystem.Reset();
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UInkSystemComponent::InitializeResolution()
+{
+    InkResolution = FIntPoint(Resolution, Resolution);
+    if (!bAutoResolution)
+    {
+        return;
+    }
+
+    if (BakedResolution.X > 0 && BakedResolution.Y > 0)
+    {
+        InkResolution = BakedResolution;
+        return;
+    }
+
+    // 加载时计算：网格 UV 数据由子系统按网格资产共享，后续的 UV 查询也会用到
+    TSharedPtr<const FInkMeshUVData> UVData = InkSubsystem.IsValid() ? InkSubsystem->GetMeshUVData(CachedMeshComponent->GetStaticMesh()) : nullptr;
+    if (!UVData.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkSystemComponent: No UV data for auto resolution on '%s', using %d."),
+               *GetNameSafe(GetOwner()), Resolution);
+        return;
+    }
+
+    InkResolution = ComputeAutoResolution(*UVData, CachedMeshComponent->GetComponentScale());
+}
+
+FIntPoint UInkSystemComponent::ComputeAutoResolution(const FInkMeshUVData &UVData, const FVector &Scale3D) const
+{
+    float WorldArea = 0.0f;
+    float UVArea = 0.0f;
+    float Aspect = 1.0f;
+    if (!UVData.ComputeUVDensity(FVector3f(Scale3D.GetAbs()), WorldArea, UVArea, Aspect))
+    {
+        return FIntPoint(Resolution, Resolution);
+    }
+
+    // 覆盖 WorldArea 的像素数 = 宽 * 高 * UVArea = (密度 * 面积(m²))
+    // => 宽 * 高 = 密度² * WorldArea / UVArea，再按 U / V 方向长度比分配宽高
+    const float WorldAreaM2 = WorldArea / (100.0f * 100.0f);
+    const float TexelArea = FMath::Square(TargetTexelsPerMeter) * WorldAreaM2 / UVArea;
+    const float AspectSqrt = FMath::Sqrt(FMath::Clamp(Aspect, 1.0f / 16.0f, 16.0f));
+    const float Side = FMath::Sqrt(TexelArea);
+
+    // 对齐到 4 像素，便于图集打包
+    auto Quantize = [this](float Value)
+    {
+        const int32 Lower = FMath::Max(MinAutoResolution, 4);
+        const int32 Upper = FMath::Max(MaxAutoResolution, Lower);
+        return FMath::Clamp(FMath::DivideAndRoundUp(FMath::CeilToInt32(Value), 4) * 4, Lower, Upper);
+    };
+
+    const FIntPoint Result(Quantize(Side * AspectSqrt), Quantize(Side / AspectSqrt));
+
+    UE_LOG(LogTemp, Log, TEXT("InkSystemComponent: Auto resolution %dx%d for '%s' (area %.1f m², UV area %.3f, aspect %.2f)"),
+           Result.X, Result.Y, *GetNameSafe(GetOwner()), WorldAreaM2, UVArea, Aspect);
+
+    return Result;
+}
+
+void UInkSystemComponent::BakeInkResolution()
+{
+    const UStaticMeshComponent *MeshComp = GetOwner() ? GetOwner()->FindComponentByClass<UStaticMeshComponent>() : nullptr;
+    TSharedPtr<const FInkMeshUVData> UVData = MeshComp ? FInkMeshUVData::Build(MeshComp->GetStaticMesh()) : nullptr;
+    if (!UVData.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkSystemComponent: Cannot bake resolution, no mesh UV data on '%s'."),
+               *GetNameSafe(GetOwner()));
+        return;
+    }
+
+    Modify();
+    BakedResolution = ComputeAutoResolution(*UVData, MeshComp->GetComponentScale());
+}
+
+void UInkSystemComponent::InitializeCoverageGrid()
+{
+    const int32 Downscale = FMath::Max(CoverageDownscale, 1);
+    const int32 GridWidth = FMath::Max(InkResolution.X / Downscale, 1);
+    const int32 GridHeight = FMath::Max(InkResolution.Y / Downscale, 1);
+    CoverageGrid.Init(GridWidth, GridHeight);
+
+    UE_LOG(LogTemp, Log, TEXT("InkSystemComponent: Created coverage grid %dx%d (%llu bytes) for '%s'"),
+           GridWidth, GridHeight, (uint64)CoverageGrid.GetAllocatedSize(), *GetNameSafe(GetOwner()));
+}
+
+FInkCoverageDelta UInkSystemComponent::StampCoverage(const FVector2D &HitUV, float BrushSize, E_Team Team)
+{
+    FInkCoverageDelta Delta;
+    if (!CoverageGrid.IsValid() || Team == E_Team::None)
+    {
+        return Delta;
+    }
+
+    TouchInk();
+    LastPaintFrame = GFrameCounter;
+
+    SCOPE_CYCLE_COUNTER(STAT_InkCoverageRaster);
+
+    // RenderTarget 像素 -> 网格像素
+    const float GridScale = static_cast<float>(CoverageGrid.GetWidth()) / FMath::Max(InkResolution.X, 1);
+    CoverageGrid.StampCircle(
+        HitUV.X * CoverageGrid.GetWidth(),
+        HitUV.Y * CoverageGrid.GetHeight(),
+        BrushSize * 0.5f * GridScale,
+        static_cast<uint8>(Team),
+        &Delta);
+
+    // 增量更新全局领地统计
+    if (InkSubsystem.IsValid() && !Delta.IsZero())
+    {
+        InkSubsystem->ApplyCoverageDelta(Delta);
+    }
+
+    return Delta;
+}
+
+float UInkSystemComponent::GetTeamCoverageRatio(E_Team Team) const
+{
+    const int32 TotalTexels = CoverageGrid.GetTotalTexels();
+    return TotalTexels > 0 ? static_cast<float>(CoverageGrid.GetTeamTexelCount(static_cast<uint8>(Team))) / TotalTexels : 0.0f;
+}
+
+E_Team UInkSystemComponent::GetInkOwnerAtUV(FVector2D UV) const
+{
+    return static_cast<E_Team>(CoverageGrid.GetOwnerAtUV(UV));
+}
+
+void UInkSystemComponent::ApplyCoverageRows(uint8 Team, int32 FirstRow, TConstArrayView<uint64> RowWords)
+{
+    FInkCoverageDelta Delta;
+    CoverageGrid.SetPlaneRows(Team, FirstRow, RowWords, &Delta);
+
+    if (InkSubsystem.IsValid() && !Delta.IsZero())
+    {
+        InkSubsystem->ApplyCoverageDelta(Delta);
+    }
+}
+
+void UInkSystemComponent::RefreshInkFromCoverage()
+{
+    if (HasInkStorage())
+    {
+        RestoreInkFromCoverage();
+    }
+    else if (HasAnyInk() && InkSubsystem.IsValid())
+    {
+        InkSubsystem->MarkSurfaceForRestore(this);
+    }
+}
+
+void UInkSystemComponent::ClearInk()
+{
+    FInkCoverageDelta Delta;
+    for (int32 TeamIndex = 0; TeamIndex < InkMaxTeams; ++TeamIndex)
+    {
+        Delta.Texels[TeamIndex] = -CoverageGrid.GetTeamTexelCount(static_cast<uint8>(TeamIndex + 1));
+    }
+    CoverageGrid.Reset();
+
+    if (InkSubsystem.IsValid() && !Delta.IsZero())
+    {
+        InkSubsystem->ApplyCoverageDelta(Delta);
+    }
+
+    if (HasInkStorage())
+    {
+        RestoreInkFromCoverage();
+    }
+}
+
+bool UInkSystemComponent::ApplyDecayMask(int32 FirstRow, TConstArrayView<uint64> MaskWords)
+{
+    FInkCoverageDelta Delta;
+    if (!CoverageGrid.ClearRowsMasked(FirstRow, MaskWords, &Delta))
+    {
+        return false;
+    }
+
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->ApplyCoverageDelta(Delta);
+    }
+    return true;
+}
+
+void UInkSystemComponent::RefreshInkRows(int32 FirstRow, int32 NumRows)
+{
+    const int32 GridWidth = CoverageGrid.GetWidth();
+    const int32 GridHeight = CoverageGrid.GetHeight();
+    if (!HasInkStorage() || !CoverageGrid.IsValid() || !InkSubsystem.IsValid())
+    {
+        return;
+    }
+
+    FirstRow = FMath::Clamp(FirstRow, 0, GridHeight);
+    NumRows = FMath::Min(NumRows, GridHeight - FirstRow);
+    if (NumRows <= 0)
+    {
+        return;
+    }
+
+    // 衰减每帧都可能刷新：复用子系统的上传纹理，只更新用到的区域，不创建 RHI 纹理
+    UTexture2D *UploadTexture = InkSubsystem->AcquireInkUploadTexture(GridWidth, NumRows);
+    if (!UploadTexture || InkSubsystem->GetInkTextureEncoding() != TextureEncoding)
+    {
+        RestoreInkFromCoverage();
+        return;
+    }
+
+    const int32 BytesPerTexel = InkEncoding::GetBytesPerTexel(TextureEncoding);
+    const uint32 SourcePitch = GridWidth * BytesPerTexel;
+    uint8 *Texels = static_cast<uint8 *>(FMemory::Malloc(SourcePitch * NumRows));
+    EncodeCoverageRows(FirstRow, NumRows, Texels);
+
+    // 数据和区域在渲染线程上传完成后释放；上传与之后的 Canvas 绘制按提交顺序在渲染线程执行
+    FUpdateTextureRegion2D *Region = new FUpdateTextureRegion2D(0, 0, 0, 0, GridWidth, NumRows);
+    UploadTexture->UpdateTextureRegions(0, 1, Region, SourcePitch, BytesPerTexel, Texels,
+                                        [](uint8 *SourceData, const FUpdateTextureRegion2D *Regions)
+                                        {
+                                            FMemory::Free(SourceData);
+                                            delete Regions;
+                                        });
+
+    DrawCoverageRows(UploadTexture, FirstRow, NumRows,
+                     FVector2D(static_cast<double>(GridWidth) / UploadTexture->GetSizeX(), static_cast<double>(NumRows) / UploadTexture->GetSizeY()));
+}
+
+bool UInkSystemComponent::HasAnyInk() const
+{
+    for (uint8 Team = 1; Team <= CoverageGrid.GetNumTeams(); ++Team)
+    {
+        if (CoverageGrid.GetTeamTexelCount(Team) > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UInkSystemComponent::WasInkRecentlyRendered(float Tolerance) const
+{
+    return CachedMeshComponent && CachedMeshComponent->WasRecentlyRendered(Tolerance);
+}
+
+bool UInkSystemComponent::EnsureInkStorage()
+{
+    if (MyRenderTarget)
+    {
+        return true;
+    }
+
+    // 专用服务器只需要 CPU 归属网格
+    if (!CachedMeshComponent || GetNetMode() == NM_DedicatedServer)
+    {
+        return false;
+    }
+
     InitializeRenderTarget();
+    if (!MyRenderTarget)
+    {
+        return false;
+    }
+
+    // 只有专属 RenderTarget 计入预算：超出时回收其他专属 RenderTarget 的表面
+    // 图集区域释放后页不会归还，回收图集表面不能降低显存，不参与预算
+    if (!IsInAtlas() && InkSubsystem.IsValid())
+    {
+        InkSubsystem->MakeRoomForInk(GetInkStorageBytes(), this);
+    }
+
     InitializeDynamicMaterial();
+
+    // 被回收过的表面：由 CPU 归属网格恢复涂色
+    if (HasAnyInk())
+    {
+        RestoreInkFromCoverage();
+    }
+
+    TouchInk();
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->OnInkStorageAllocated(this);
+    }
+
+    return true;
+}
+
+void UInkSystemComponent::ReleaseInkStorage()
+{
+    if (!MyRenderTarget)
+    {
+        return;
+    }
+
+    // 在清除图集区域之前通知，子系统据此判断是否计入预算
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->OnInkStorageReleased(this);
+    }
+
+    if (AtlasSlot.IsValid())
+    {
+        if (UInkAtlas *Atlas = InkSubsystem.IsValid() ? InkSubsystem->GetAtlas() : nullptr)
+        {
+            Atlas->Free(AtlasSlot);
+        }
+        AtlasSlot = FInkAtlasSlot();
+    }
+
+    // 恢复原材质：图集区域可能被其他表面复用，不能继续引用共享页
+    if (CachedMeshComponent && MyDynamicMaterial)
+    {
+        CachedMeshComponent->SetMaterial(MaterialSlotIndex, OriginalMaterial);
+    }
+
+    MyRenderTarget = nullptr;
+    MyDynamicMaterial = nullptr;
+    InkRect = FIntRect();
+}
+
+void UInkSystemComponent::RestoreInkFromCoverage()
+{
+    const int32 GridWidth = CoverageGrid.GetWidth();
+    const int32 GridHeight = CoverageGrid.GetHeight();
+    if (!MyRenderTarget || !CoverageGrid.IsValid())
+    {
+        return;
+    }
+
+    // 整体恢复只在分配存储时发生一次，使用临时纹理
+    UTexture2D *RestoreTexture = UTexture2D::CreateTransient(GridWidth, GridHeight, InkEncoding::GetPixelFormat(TextureEncoding));
+    if (!RestoreTexture)
+    {
+        return;
+    }
+    RestoreTexture->SRGB = false;
+
+    FTexture2DMipMap &Mip = RestoreTexture->GetPlatformData()->Mips[0];
+    EncodeCoverageRows(0, GridHeight, static_cast<uint8 *>(Mip.BulkData.Lock(LOCK_READ_WRITE)));
+    Mip.BulkData.Unlock();
+    RestoreTexture->UpdateResource();
+
+    DrawCoverageRows(RestoreTexture, 0, GridHeight, FVector2D::UnitVector);
+
+    UE_LOG(LogTemp, Verbose, TEXT("InkSystemComponent: Restored %dx%d coverage grid on '%s'"),
+           GridWidth, GridHeight, *GetNameSafe(GetOwner()));
+}
+
+void UInkSystemComponent::EncodeCoverageRows(int32 FirstRow, int32 NumRows, uint8 *OutTexels) const
+{
+    const int32 GridWidth = CoverageGrid.GetWidth();
+    if (TextureEncoding == EInkTextureEncoding::PackedR8)
+    {
+        // 与画刷材质一致：调色板下标 + 满覆盖度
+        static_assert(InkMaxTeams <= InkEncoding::MaxPackedTeams, "PackedR8 palette cannot hold all teams");
+        for (int32 Row = 0; Row < NumRows; ++Row)
+        {
+            uint8 *Texel = OutTexels + Row * GridWidth;
+            for (int32 X = 0; X < GridWidth; ++X)
+            {
+                Texel[X] = InkEncoding::EncodeTexel(CoverageGrid.GetOwner(X, FirstRow + Row));
+            }
+        }
+    }
+    else
+    {
+        // 与画刷材质一致：Team1 写 R 通道，Team2 写 G 通道
+        static_assert(InkMaxTeams <= InkEncoding::MaxChannelTeams, "TeamChannels encoding only holds two teams");
+        for (int32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (int32 X = 0; X < GridWidth; ++X)
+            {
+                const uint8 Owner = CoverageGrid.GetOwner(X, FirstRow + Row);
+                uint8 *Texel = OutTexels + (Row * GridWidth + X) * 2;
+                Texel[0] = Owner == static_cast<uint8>(E_Team::Team1) ? 255 : 0;
+                Texel[1] = Owner == static_cast<uint8>(E_Team::Team2) ? 255 : 0;
+            }
+        }
+    }
+}
+
+void UInkSystemComponent::DrawCoverageRows(UTexture *SourceTexture, int32 FirstRow, int32 NumRows, const FVector2D &SourceUVSize)
+{
+    UCanvas *Canvas = nullptr;
+    FVector2D CanvasSize;
+    FDrawToRenderTargetContext Context;
+
+    UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, MyRenderTarget, Canvas, CanvasSize, Context);
+
+    if (Canvas)
+    {
+        // 网格行 -> 表面区域内的像素行
+        const double RowScale = static_cast<double>(InkRect.Height()) / CoverageGrid.GetHeight();
+        Canvas->K2_DrawTexture(
+            SourceTexture,
+            FVector2D(InkRect.Min.X, InkRect.Min.Y + FirstRow * RowScale),
+            FVector2D(InkRect.Width(), NumRows * RowScale),
+            FVector2D::ZeroVector,
+            SourceUVSize,
+            FLinearColor::White,
+            EBlendMode::BLEND_Opaque);
+    }
+
+    UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
 }
 
 void UInkSystemComponent::InitializeRenderTarget()
 {
+    // 优先从共享图集分配区域
+    UInkAtlas *Atlas = (bUseSharedAtlas && InkSubsystem.IsValid()) ? InkSubsystem->GetAtlas() : nullptr;
+    if (Atlas && Atlas->Allocate(InkResolution, AtlasSlot))
+    {
+        MyRenderTarget = Atlas->GetPageRenderTarget(AtlasSlot.PageIndex);
+        InkRect = AtlasSlot.Rect;
+
+        UE_LOG(LogTemp, Log, TEXT("InkSystemComponent: Allocated %dx%d atlas rect at (%d, %d) on page %d for '%s'"),
+               InkResolution.X, InkResolution.Y, InkRect.Min.X, InkRect.Min.Y, AtlasSlot.PageIndex, *GetNameSafe(GetOwner()));
+        return;
+    }
+
+    if (Atlas)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkSystemComponent: Resolution %dx%d does not fit atlas page on '%s', using dedicated RenderTarget."),
+               InkResolution.X, InkResolution.Y, *GetNameSafe(GetOwner()));
+    }
+
     // 使用 Kismet 库创建 Render Target（自动处理资源管理）
     MyRenderTarget = UKismetRenderingLibrary::CreateRenderTarget2D(
         this,
-        Resolution,
-        Resolution,
-        ETextureRenderTargetFormat::RTF_RG8 // 只需要 R 和 G 通道，节省内存
+        InkResolution.X,
+        InkResolution.Y,
+        InkEncoding::GetRenderTargetFormat(TextureEncoding) // RG8 或 R8，见 InkEncoding.h
     );
+    InkRect = FIntRect(FIntPoint::ZeroValue, InkResolution);
 
     if (MyRenderTarget)
     {
@@ -52,7 +516,7 @@ void UInkSystemComponent::InitializeRenderTarget()
         UKismetRenderingLibrary::ClearRenderTarget2D(this, MyRenderTarget, FLinearColor::Black);
 
         UE_LOG(LogTemp, Log, TEXT("InkSystemComponent: Created RenderTarget %dx%d for '%s'"),
-               Resolution, Resolution, *GetNameSafe(GetOwner()));
+               InkResolution.X, InkResolution.Y, *GetNameSafe(GetOwner()));
     }
     else
     {
@@ -68,8 +532,8 @@ void UInkSystemComponent::InitializeDynamicMaterial()
         return;
     }
 
-    // 获取当前材质
-    UMaterialInterface *BaseMaterial = CachedMeshComponent->GetMaterial(MaterialSlotIndex);
+    // 使用 BeginPlay 时记录的原材质
+    UMaterialInterface *BaseMaterial = OriginalMaterial;
     if (!BaseMaterial)
     {
         UE_LOG(LogTemp, Warning, TEXT("InkSystemComponent: No material at slot %d on '%s'!"),
@@ -77,8 +541,24 @@ void UInkSystemComponent::InitializeDynamicMaterial()
         return;
     }
 
-    // 创建动态材质实例
-    MyDynamicMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+    // 图集表面共用同页、同基础材质的动态材质实例，保留绘制合批
+    UInkAtlas *Atlas = (AtlasSlot.IsValid() && InkSubsystem.IsValid()) ? InkSubsystem->GetAtlas() : nullptr;
+    if (Atlas)
+    {
+        MyDynamicMaterial = Atlas->GetPageMaterial(BaseMaterial, AtlasSlot.PageIndex);
+    }
+    else
+    {
+        // 创建动态材质实例
+        MyDynamicMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+        if (MyDynamicMaterial)
+        {
+            // 设置 Render Target 纹理参数（对应 M_Inkable_Surface 中的 "InkRT" 参数）
+            MyDynamicMaterial->SetTextureParameterValue(FName(TEXT("InkRT")), MyRenderTarget);
+            MyDynamicMaterial->SetScalarParameterValue(FName(TEXT("InkEncoding")), InkEncoding::GetMaterialSwitch(TextureEncoding));
+        }
+    }
+
     if (!MyDynamicMaterial)
     {
         UE_LOG(LogTemp, Error, TEXT("InkSystemComponent: Failed to create Dynamic Material for '%s'!"),
@@ -86,12 +566,26 @@ void UInkSystemComponent::InitializeDynamicMaterial()
         return;
     }
 
-    // 设置 Render Target 纹理参数（对应 M_Inkable_Surface 中的 "InkRT" 参数）
-    MyDynamicMaterial->SetTextureParameterValue(FName(TEXT("InkRT")), MyRenderTarget);
-
     // 将动态材质应用回网格
     CachedMeshComponent->SetMaterial(MaterialSlotIndex, MyDynamicMaterial);
+    ApplyInkRectToPrimitive();
 
     UE_LOG(LogTemp, Log, TEXT("InkSystemComponent: Bound InkRT to Dynamic Material on '%s'"),
            *GetNameSafe(GetOwner()));
 }
+
+void UInkSystemComponent::ApplyInkRectToPrimitive()
+{
+    if (!CachedMeshComponent || !MyRenderTarget)
+    {
+        return;
+    }
+
+    // InkUV = UV1 * Scale + Offset
+    const FVector2D TextureSize(MyRenderTarget->SizeX, MyRenderTarget->SizeY);
+    const FVector2D Offset = FVector2D(InkRect.Min) / TextureSize;
+    const FVector2D Scale = FVector2D(InkRect.Size()) / TextureSize;
+
+    CachedMeshComponent->SetCustomPrimitiveDataVector4(InkCustomDataIndex, FVector4(Offset.X, Offset.Y, Scale.X, Scale.Y));
+    CachedMeshComponent->SetCustomPrimitiveDataFloat(InkCustomDataIndex + 4, AtlasSlot.IsValid() ? AtlasSlot.PageIndex : 0.0f);
+}
@@ -4,16 +4,30 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "ShooterGameMode.h"
+#include "InkCoverageGrid.h"
+#include "InkAtlas.h"
 #include "InkSystemComponent.generated.h"
 
+class UTexture;
 class UTextureRenderTarget2D;
 class UMaterialInstanceDynamic;
+class UMaterialInterface;
 class UStaticMeshComponent;
+class UInkWorldSubsystem;
+struct FInkMeshUVData;
 
 /**
  * 可涂色表面组件
  * 附加到可被涂色的 Actor 上（墙壁、地板等）
- * 管理该 Actor 专属的 RenderTarget 和动态材质实例
+ * 默认从墨水子系统的共享图集中分配一块区域，并与同页表面共用动态材质实例；
+ * 区域的偏移和缩放通过 CustomPrimitiveData 传给材质
+ * 图集未启用或表面超过页大小时，退回使用专属 RenderTarget 和动态材质实例
+ * 同时维护一份 CPU 端归属网格，供玩法逻辑直接查询涂色归属
+ *
+ * GPU 存储在第一次涂色时才分配；超出子系统内存预算时，最久未使用的表面会被回收，
+ * 只保留 CPU 归属网格（每像素 1 bit / 队伍），再次涂色或重新可见时由网格恢复
+ * 恢复时由归属网格上采样，画刷的柔和边缘会变为网格精度的硬边
  */
 UCLASS(ClassGroup = (Ink), meta = (BlueprintSpawnableComponent))
 class PROJECT2_API UInkSystemComponent : public UActorComponent
@@ -25,44 +39,233 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // ========== 属性 ==========
 
-    /** 存储涂色数据的 Render Target */
+    /** 存储涂色数据的 Render Target（使用图集时为所在页） */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ink")
     TObjectPtr<UTextureRenderTarget2D> MyRenderTarget;
 
-    /** M_Inkable_Surface 的动态材质实例 */
+    /** M_Inkable_Surface 的动态材质实例（使用图集时与同页表面共享） */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ink")
     TObjectPtr<UMaterialInstanceDynamic> MyDynamicMaterial;
 
-    /** Render Target 分辨率（宽高相同） */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink", meta = (ClampMin = 128, ClampMax = 2048))
+    /** 固定的 Render Target 分辨率（宽高相同），关闭 bAutoResolution 时使用 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink", meta = (ClampMin = 128, ClampMax = 2048, EditCondition = "!bAutoResolution"))
     int32 Resolution = 512;
 
+    /** 根据网格表面积和 UV1 覆盖面积自动计算分辨率，使墨水密度在各表面间一致 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Resolution")
+    bool bAutoResolution = true;
+
+    /** 自动分辨率的目标墨水密度（像素 / 米） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Resolution", meta = (ClampMin = 1, ClampMax = 1024, EditCondition = "bAutoResolution"))
+    float TargetTexelsPerMeter = 64.0f;
+
+    /** 自动分辨率的单边下限 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Resolution", meta = (ClampMin = 16, ClampMax = 4096, EditCondition = "bAutoResolution"))
+    int32 MinAutoResolution = 32;
+
+    /** 自动分辨率的单边上限 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Resolution", meta = (ClampMin = 16, ClampMax = 4096, EditCondition = "bAutoResolution"))
+    int32 MaxAutoResolution = 2048;
+
+    /** 编辑器中烘焙的自动分辨率，非零时跳过加载时的计算（网格或缩放改变后需重新烘焙） */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ink|Resolution")
+    FIntPoint BakedResolution = FIntPoint::ZeroValue;
+
     /** 要应用动态材质的材质槽索引 */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink", meta = (ClampMin = 0))
     int32 MaterialSlotIndex = 0;
 
+    /** 是否从共享图集分配（子系统关闭图集时无效） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Atlas")
+    bool bUseSharedAtlas = true;
+
+    /**
+     * 图集区域参数在 CustomPrimitiveData 中的起始下标
+     * [Index..Index+3] = (OffsetU, OffsetV, ScaleU, ScaleV)，[Index+4] = 页索引
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Atlas", meta = (ClampMin = 0, ClampMax = 31))
+    int32 InkCustomDataIndex = 0;
+
+    /** CPU 归属网格相对 RenderTarget 的降采样倍数（1 = 与 RenderTarget 同分辨率） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ink|Coverage", meta = (ClampMin = 1, ClampMax = 16))
+    int32 CoverageDownscale = 1;
+
     // ========== 公开方法 ==========
 
     /** 获取 RenderTarget 用于绘制 */
     UFUNCTION(BlueprintCallable, Category = "Ink")
     UTextureRenderTarget2D *GetRenderTarget() const { return MyRenderTarget; }
 
-    /** 获取当前分辨率 */
+    /** 获取当前分辨率（较长的一边） */
     UFUNCTION(BlueprintPure, Category = "Ink")
-    int32 GetResolution() const { return Resolution; }
+    int32 GetResolution() const { return InkResolution.GetMax(); }
+
+    /** 获取实际使用的分辨率（宽, 高） */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    FIntPoint GetInkResolution() const { return InkResolution; }
+
+    /** 按当前网格和缩放计算自动分辨率并保存到 BakedResolution */
+    UFUNCTION(CallInEditor, Category = "Ink|Resolution")
+    void BakeInkResolution();
+
+    /** 该表面在 RenderTarget 中的像素区域（专属 RenderTarget 时为整张纹理） */
+    const FIntRect &GetInkRect() const { return InkRect; }
+
+    /** 是否使用共享图集 */
+    UFUNCTION(BlueprintPure, Category = "Ink|Atlas")
+    bool IsInAtlas() const { return AtlasSlot.IsValid(); }
+
+    // ========== GPU 存储 ==========
+
+    /**
+     * 确保 GPU 存储已分配（首次涂色或被回收后重新使用时调用）
+     * 重新分配时会把 CPU 归属网格恢复到 RenderTarget
+     * @return	RenderTarget 是否可用（专用服务器上始终为 false）
+     */
+    bool EnsureInkStorage();
+
+    /** 释放 GPU 存储并恢复原材质，CPU 归属网格保留 */
+    void ReleaseInkStorage();
+
+    /** 是否已分配 GPU 存储 */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    bool HasInkStorage() const { return MyRenderTarget != nullptr; }
+
+    /** 当前 GPU 存储占用的字节数（RG8 每像素 2 字节，PackedR8 每像素 1 字节） */
+    int64 GetInkStorageBytes() const { return HasInkStorage() ? static_cast<int64>(InkRect.Area()) * InkEncoding::GetBytesPerTexel(TextureEncoding) : 0; }
+
+    /** 分配 GPU 存储所需的字节数 */
+    int64 GetRequiredInkStorageBytes() const { return static_cast<int64>(InkResolution.X) * InkResolution.Y * InkEncoding::GetBytesPerTexel(TextureEncoding); }
+
+    /** 表面上是否有任何墨水 */
+    bool HasAnyInk() const;
+
+    /** 标记为最近使用（涂色或可见），用于 LRU 回收 */
+    void TouchInk() { LastInkUseTime = FPlatformTime::Seconds(); }
+
+    /** 最近一次使用的时间（FPlatformTime::Seconds） */
+    double GetLastInkUseTime() const { return LastInkUseTime; }
+
+    /** 最近一次涂色所在的帧（GFrameCounter） */
+    uint64 GetLastPaintFrame() const { return LastPaintFrame; }
+
+    /** 表面网格最近是否被渲染 */
+    bool WasInkRecentlyRendered(float Tolerance) const;
+
+    /**
+     * 将一次画刷写入 CPU 归属网格，并把各队伍的像素变化同步给墨水子系统
+     * @param HitUV				命中的 UV 坐标（0-1 范围）
+     * @param BrushSize			画刷大小（RenderTarget 像素）
+     * @param Team				写入的队伍
+     * @return					本次写入造成的各队伍像素变化
+     */
+    FInkCoverageDelta StampCoverage(const FVector2D &HitUV, float BrushSize, E_Team Team);
+
+    /** 查询指定 UV 处的涂色归属队伍（纯 CPU 查询，不回读 GPU） */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    E_Team GetInkOwnerAtUV(FVector2D UV) const;
+
+    /** 指定队伍在该表面上的涂色比例（0-1） */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    float GetTeamCoverageRatio(E_Team Team) const;
+
+    /** 获取 CPU 归属网格 */
+    const FInkCoverageGrid &GetCoverageGrid() const { return CoverageGrid; }
+
+    // ========== 快照 ==========
+
+    /** 稳定的表面 ID（组件路径去除 PIE 前缀后的 CRC32），服务器与客户端一致 */
+    uint32 GetSurfaceId() const { return SurfaceId; }
+
+    /** 记录归属网格的当前修订号（之后修改的行修订号更大） */
+    uint32 CaptureCoverageRevision() { return CoverageGrid.CaptureRevision(); }
+
+    /** 覆盖写入归属网格中某个队伍的连续行（快照恢复），并同步领地统计 */
+    void ApplyCoverageRows(uint8 Team, int32 FirstRow, TConstArrayView<uint64> RowWords);
+
+    /** 归属网格被外部替换后刷新 GPU 显示（未分配存储时等可见后再恢复） */
+    void RefreshInkFromCoverage();
+
+    /** 清除表面上的所有墨水（归属网格、领地统计和 GPU） */
+    void ClearInk();
+
+    /**
+     * 衰减：清除归属网格中从 FirstRow 开始、掩码为 1 的像素，并同步领地统计（GPU 由 RefreshInkRows 更新）
+     * @return	是否有像素被清除
+     */
+    bool ApplyDecayMask(int32 FirstRow, TConstArrayView<uint64> MaskWords);
+
+    /**
+     * 只把归属网格中 [FirstRow, FirstRow + NumRows) 行重新绘制到 GPU（未分配存储时无需处理，分配时会整体恢复）
+     * 经子系统共用的上传纹理更新区域，不创建临时纹理
+     */
+    void RefreshInkRows(int32 FirstRow, int32 NumRows);
 
 protected:
     /** 缓存的 Owner 的静态网格组件 */
     UPROPERTY()
     TObjectPtr<UStaticMeshComponent> CachedMeshComponent;
 
+    /** CPU 端归属网格 */
+    FInkCoverageGrid CoverageGrid;
+
+    /** 注册到的墨水子系统 */
+    TWeakObjectPtr<UInkWorldSubsystem> InkSubsystem;
+
+    /** RenderTarget 编码（BeginPlay 时取自子系统） */
+    EInkTextureEncoding TextureEncoding = EInkTextureEncoding::TeamChannels;
+
+    /** 图集中分配到的区域 */
+    FInkAtlasSlot AtlasSlot;
+
+    /** 在 MyRenderTarget 中的像素区域 */
+    FIntRect InkRect;
+
+    /** 实际使用的分辨率，BeginPlay 时确定 */
+    FIntPoint InkResolution = FIntPoint(512, 512);
+
+    /** 替换为动态材质之前的原材质，回收 GPU 存储时恢复 */
+    UPROPERTY()
+    TObjectPtr<UMaterialInterface> OriginalMaterial;
+
+    /** 稳定的表面 ID */
+    uint32 SurfaceId = 0;
+
+    /** 最近一次使用的时间 */
+    double LastInkUseTime = 0.0;
+
+    /** 最近一次涂色所在的帧，本帧涂过的表面不会被回收（帧末还有待绘制的画刷） */
+    uint64 LastPaintFrame = 0;
+
+    /** 确定实际分辨率（烘焙值 / 自动计算 / 固定值） */
+    void InitializeResolution();
+
+    /** 由网格 UV 数据和组件缩放计算分辨率 */
+    FIntPoint ComputeAutoResolution(const FInkMeshUVData &UVData, const FVector &Scale3D) const;
+
+    /** 初始化 CPU 归属网格 */
+    void InitializeCoverageGrid();
+
     /** 初始化 Render Target */
     void InitializeRenderTarget();
 
     /** 初始化动态材质并绑定 Render Target */
     void InitializeDynamicMaterial();
+
+    /** 将区域偏移 / 缩放写入 CustomPrimitiveData */
+    void ApplyInkRectToPrimitive();
+
+    /** 将整个 CPU 归属网格绘制到 RenderTarget 区域（分配存储时一次性恢复，使用临时纹理） */
+    void RestoreInkFromCoverage();
+
+    /** 把归属网格 [FirstRow, FirstRow + NumRows) 行按 TextureEncoding 编码，行距为网格宽度 */
+    void EncodeCoverageRows(int32 FirstRow, int32 NumRows, uint8 *OutTexels) const;
+
+    /** 把源纹理左上角 SourceUVSize 范围绘制到表面区域中对应网格行的位置 */
+    void DrawCoverageRows(UTexture *SourceTexture, int32 FirstRow, int32 NumRows, const FVector2D &SourceUVSize);
 };
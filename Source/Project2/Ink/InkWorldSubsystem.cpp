@@ -0,0 +1,874 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkWorldSubsystem.h"
+#include "InkStats.h"
+#include "InkSystemComponent.h"
+#include "PaintManager.h"
+#include "InkMeshUVData.h"
+#include "InkAtlas.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+
+void UInkWorldSubsystem::Initialize(FSubsystemCollectionBase &Collection)
+{
+    Super::Initialize(Collection);
+
+    if (bUseInkAtlas)
+    {
+        Atlas = NewObject<UInkAtlas>(this);
+        Atlas->Initialize(AtlasPageSize, AtlasPadding, InkTextureEncoding);
+    }
+
+    StampJournal.SetCapacity(JournalCapacity);
+}
+
+void UInkWorldSubsystem::Deinitialize()
+{
+    SurfacesByPrimitive.Reset();
+    SurfacesById.Reset();
+    RegisteredSurfaces.Reset();
+    SpatialCells.Reset();
+    OversizedSurfaces.Reset();
+    PaintManager.Reset();
+    MeshUVDataCache.Reset();
+    Atlas = nullptr;
+    InkUploadTexture = nullptr;
+    ResidentSurfaces.Reset();
+    EvictedSurfaces.Reset();
+    ResidentInkBytes = 0;
+    DecayScheduler.Reset();
+    StampJournal.SetCapacity(0);
+    TotalTexels = 0;
+    FMemory::Memzero(TeamTexels);
+
+    Super::Deinitialize();
+}
+
+bool UInkWorldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在实际游戏世界中运行
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UInkWorldSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UInkWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UInkWorldSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    ResidencyCheckTimer -= DeltaTime;
+    if (ResidencyCheckTimer <= 0.0f)
+    {
+        ResidencyCheckTimer = ResidencyCheckInterval;
+        UpdateResidency();
+    }
+
+    // 衰减结果既不同步也不写入画刷日志，只在单机上运行
+    if (IsInkDecayEnabled())
+    {
+        SCOPE_CYCLE_COUNTER(STAT_InkDecay);
+
+        FInkDecaySettings Settings;
+        Settings.HalfLife = InkDecayHalfLife;
+        Settings.TileRows = InkDecayTileRows;
+        Settings.MaxTilesPerFrame = InkDecayMaxTilesPerFrame;
+        Settings.BudgetMicroseconds = InkDecayBudgetMicroseconds;
+        DecayScheduler.Tick(*this, Settings);
+    }
+
+    RecordFrameStats();
+}
+
+void UInkWorldSubsystem::RecordFrameStats() const
+{
+    // RenderTarget 显存：图集页按整页计入，加上独占 RenderTarget
+    int64 StorageBytes = Atlas ? Atlas->GetPageBytes() * Atlas->GetNumPages() : 0;
+    for (const TWeakObjectPtr<UInkSystemComponent> &Resident : ResidentSurfaces)
+    {
+        const UInkSystemComponent *Surface = Resident.Get();
+        if (Surface && !Surface->IsInAtlas())
+        {
+            StorageBytes += Surface->GetInkStorageBytes();
+        }
+    }
+    SET_MEMORY_STAT(STAT_InkStorageMemory, StorageBytes);
+
+#if CSV_PROFILER
+    const APaintManager *Manager = PaintManager.Get();
+    const FInkStampCounters Counters = Manager ? Manager->GetLastFlushCounters() : FInkStampCounters();
+    CSV_CUSTOM_STAT(Ink, StampsPerFrame, Counters.StampsPainted, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Ink, SurfacesPainted, Counters.SurfacesPainted, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Ink, LiveProjectiles, InkStats::LiveProjectiles, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(Ink, StorageMB, static_cast<float>(StorageBytes / (1024.0 * 1024.0)), ECsvCustomStatOp::Set);
+#endif
+}
+
+void UInkWorldSubsystem::SetInkDecayEnabled(bool bEnabled)
+{
+    if (bEnabled && !CanRunInkDecay())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkWorldSubsystem: ink decay is only supported in standalone games"));
+        return;
+    }
+
+    if (bEnableInkDecay != bEnabled)
+    {
+        bEnableInkDecay = bEnabled;
+        DecayScheduler.Reset();
+    }
+}
+
+bool UInkWorldSubsystem::IsInkDecayEnabled() const
+{
+    return bEnableInkDecay && CanRunInkDecay();
+}
+
+bool UInkWorldSubsystem::CanRunInkDecay() const
+{
+    const UWorld *World = GetWorld();
+    return World && World->GetNetMode() == NM_Standalone;
+}
+
+void UInkWorldSubsystem::UpdateResidency()
+{
+    const float VisibleTolerance = ResidencyCheckInterval + 0.1f;
+
+    // 可见的常驻表面视为最近使用
+    for (const TWeakObjectPtr<UInkSystemComponent> &Resident : ResidentSurfaces)
+    {
+        UInkSystemComponent *Surface = Resident.Get();
+        if (Surface && Surface->WasInkRecentlyRendered(VisibleTolerance))
+        {
+            Surface->TouchInk();
+        }
+    }
+
+    // 被回收的表面重新可见时恢复（EnsureInkStorage 会把自身移出 EvictedSurfaces）
+    int32 NumRestored = 0;
+    for (int32 Index = EvictedSurfaces.Num() - 1; Index >= 0 && NumRestored < MaxRestoresPerCheck; --Index)
+    {
+        UInkSystemComponent *Surface = EvictedSurfaces[Index].Get();
+        if (!Surface)
+        {
+            EvictedSurfaces.RemoveAtSwap(Index);
+            continue;
+        }
+
+        if (Surface->WasInkRecentlyRendered(VisibleTolerance) && Surface->EnsureInkStorage())
+        {
+            ++NumRestored;
+        }
+    }
+}
+
+void UInkWorldSubsystem::MakeRoomForInk(int64 Bytes, const UInkSystemComponent *Requester)
+{
+    if (InkMemoryBudgetMB <= 0)
+    {
+        return;
+    }
+
+    const int64 BudgetBytes = static_cast<int64>(InkMemoryBudgetMB) * 1024 * 1024;
+
+    // 最近使用过的表面（仍然可见或刚恢复）不回收，否则会在下一次检查时立即恢复，再挤掉另一个可见表面
+    const double EvictableBefore = FPlatformTime::Seconds() - MinInkResidentTime;
+
+    TGuardValue<bool> EvictingGuard(bEvicting, true);
+    while (ResidentInkBytes + Bytes > BudgetBytes)
+    {
+        // 线性查找最久未使用的表面（只在超出预算时发生）
+        int32 OldestIndex = INDEX_NONE;
+        double OldestTime = EvictableBefore;
+        for (int32 Index = 0; Index < ResidentSurfaces.Num(); ++Index)
+        {
+            const UInkSystemComponent *Surface = ResidentSurfaces[Index].Get();
+            if (!Surface || Surface == Requester || Surface->IsInAtlas() || Surface->GetLastPaintFrame() == GFrameCounter)
+            {
+                continue;
+            }
+
+            if (Surface->GetLastInkUseTime() < OldestTime)
+            {
+                OldestTime = Surface->GetLastInkUseTime();
+                OldestIndex = Index;
+            }
+        }
+
+        if (OldestIndex == INDEX_NONE)
+        {
+            // 剩下的都是本帧涂过或最近使用过的表面，暂时超出
+            break;
+        }
+
+        UInkSystemComponent *Victim = ResidentSurfaces[OldestIndex].Get();
+        ResidentInkBytes -= GetBudgetedInkBytes(*Victim);
+        ResidentSurfaces.RemoveAtSwap(OldestIndex);
+
+        if (Victim->HasAnyInk())
+        {
+            EvictedSurfaces.AddUnique(Victim);
+        }
+        Victim->ReleaseInkStorage();
+
+        UE_LOG(LogTemp, Verbose, TEXT("InkWorldSubsystem: Evicted ink storage of '%s' (resident %lld bytes)"),
+               *GetNameSafe(Victim->GetOwner()), ResidentInkBytes);
+    }
+}
+
+void UInkWorldSubsystem::MarkSurfaceForRestore(UInkSystemComponent *Surface)
+{
+    if (Surface && !Surface->HasInkStorage())
+    {
+        EvictedSurfaces.AddUnique(Surface);
+    }
+}
+
+UTexture2D *UInkWorldSubsystem::AcquireInkUploadTexture(int32 Width, int32 Height)
+{
+    if (InkUploadTexture && InkUploadTexture->GetSizeX() >= Width && InkUploadTexture->GetSizeY() >= Height)
+    {
+        return InkUploadTexture;
+    }
+
+    const int32 SizeX = FMath::RoundUpToPowerOfTwo(FMath::Max(Width, InkUploadTexture ? InkUploadTexture->GetSizeX() : 1));
+    const int32 SizeY = FMath::RoundUpToPowerOfTwo(FMath::Max(Height, InkUploadTexture ? InkUploadTexture->GetSizeY() : 1));
+    InkUploadTexture = UTexture2D::CreateTransient(SizeX, SizeY, InkEncoding::GetPixelFormat(InkTextureEncoding));
+    if (InkUploadTexture)
+    {
+        // 只使用左上角的一部分，最近点采样避免混入区域外的旧数据
+        InkUploadTexture->SRGB = false;
+        InkUploadTexture->Filter = TF_Nearest;
+        InkUploadTexture->UpdateResource();
+    }
+    return InkUploadTexture;
+}
+
+int64 UInkWorldSubsystem::GetBudgetedInkBytes(const UInkSystemComponent &Surface)
+{
+    return Surface.IsInAtlas() ? 0 : Surface.GetInkStorageBytes();
+}
+
+void UInkWorldSubsystem::OnInkStorageAllocated(UInkSystemComponent *Surface)
+{
+    ResidentSurfaces.AddUnique(Surface);
+    EvictedSurfaces.RemoveSwap(Surface);
+    ResidentInkBytes += GetBudgetedInkBytes(*Surface);
+}
+
+void UInkWorldSubsystem::OnInkStorageReleased(UInkSystemComponent *Surface)
+{
+    // 回收路径已在 MakeRoomForInk 中处理
+    if (bEvicting)
+    {
+        return;
+    }
+
+    if (ResidentSurfaces.RemoveSwap(Surface) > 0)
+    {
+        ResidentInkBytes -= GetBudgetedInkBytes(*Surface);
+    }
+}
+
+FIntVector UInkWorldSubsystem::ToCell(const FVector &Location)
+{
+    return FIntVector(
+        FMath::FloorToInt32(Location.X / SpatialCellSize),
+        FMath::FloorToInt32(Location.Y / SpatialCellSize),
+        FMath::FloorToInt32(Location.Z / SpatialCellSize));
+}
+
+void UInkWorldSubsystem::RegisterSurface(UInkSystemComponent *Surface, UPrimitiveComponent *SurfacePrimitive)
+{
+    if (!Surface || !SurfacePrimitive)
+    {
+        return;
+    }
+
+    // 重复注册时先移除旧记录
+    UnregisterSurface(Surface);
+
+    FRegisteredSurface Entry;
+    Entry.Surface = Surface;
+    Entry.Primitive = SurfacePrimitive;
+    UpdateSurfaceTransform(Entry, SurfacePrimitive);
+
+    if (UStaticMeshComponent *MeshComp = Cast<UStaticMeshComponent>(SurfacePrimitive))
+    {
+        Entry.UVData = GetMeshUVData(MeshComp->GetStaticMesh());
+    }
+
+    const TObjectKey<UInkSystemComponent> SurfaceKey(Surface);
+    AddToSpatialHash(SurfaceKey, Entry);
+
+    SurfacesByPrimitive.Add(SurfacePrimitive, Surface);
+    RegisteredSurfaces.Add(SurfaceKey, Entry);
+
+    // 可移动的表面在移动后刷新缓存的变换，保证 UV 查询使用当前位置
+    SurfacePrimitive->TransformUpdated.AddUObject(this, &UInkWorldSubsystem::OnSurfaceTransformUpdated);
+
+    if (const TWeakObjectPtr<UInkSystemComponent> *Existing = SurfacesById.Find(Surface->GetSurfaceId()); Existing && Existing->IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkWorldSubsystem: Surface id %08x of '%s' collides with '%s'."),
+               Surface->GetSurfaceId(), *GetNameSafe(Surface->GetOwner()), *GetNameSafe((*Existing)->GetOwner()));
+    }
+    SurfacesById.Add(Surface->GetSurfaceId(), Surface);
+
+    // 计入领地统计
+    const FInkCoverageGrid &Grid = Surface->GetCoverageGrid();
+    TotalTexels += Grid.GetTotalTexels();
+    for (int32 TeamIndex = 0; TeamIndex < InkMaxTeams; ++TeamIndex)
+    {
+        TeamTexels[TeamIndex] += Grid.GetTeamTexelCount(static_cast<uint8>(TeamIndex + 1));
+    }
+}
+
+void UInkWorldSubsystem::UnregisterSurface(UInkSystemComponent *Surface)
+{
+    const TObjectKey<UInkSystemComponent> SurfaceKey(Surface);
+
+    FRegisteredSurface Entry;
+    if (!RegisteredSurfaces.RemoveAndCopyValue(SurfaceKey, Entry))
+    {
+        return;
+    }
+
+    SurfacesByPrimitive.Remove(Entry.Primitive);
+    if (UPrimitiveComponent *SurfacePrimitive = Entry.Primitive.ResolveObjectPtr())
+    {
+        SurfacePrimitive->TransformUpdated.RemoveAll(this);
+    }
+    EvictedSurfaces.RemoveSwap(Surface);
+    if (const TWeakObjectPtr<UInkSystemComponent> *Existing = SurfacesById.Find(Surface->GetSurfaceId()); Existing && Existing->Get() == Surface)
+    {
+        SurfacesById.Remove(Surface->GetSurfaceId());
+    }
+
+    // 从领地统计中移除
+    const FInkCoverageGrid &Grid = Surface->GetCoverageGrid();
+    TotalTexels -= Grid.GetTotalTexels();
+    for (int32 TeamIndex = 0; TeamIndex < InkMaxTeams; ++TeamIndex)
+    {
+        TeamTexels[TeamIndex] -= Grid.GetTeamTexelCount(static_cast<uint8>(TeamIndex + 1));
+    }
+
+    RemoveFromSpatialHash(SurfaceKey, Entry);
+}
+
+void UInkWorldSubsystem::UpdateSurfaceTransform(FRegisteredSurface &Entry, const UPrimitiveComponent *SurfacePrimitive)
+{
+    Entry.Bounds = SurfacePrimitive->Bounds.GetBox();
+    Entry.MinCell = ToCell(Entry.Bounds.Min);
+    Entry.MaxCell = ToCell(Entry.Bounds.Max);
+
+    const FIntVector CellSpan = Entry.MaxCell - Entry.MinCell + FIntVector(1);
+    Entry.bOversized = (int64)CellSpan.X * CellSpan.Y * CellSpan.Z > MaxCellsPerSurface;
+
+    const FVector OldScale = Entry.ComponentToWorld.GetScale3D();
+    Entry.ComponentToWorld = SurfacePrimitive->GetComponentTransform();
+    Entry.MinScale = FMath::Max(static_cast<float>(Entry.ComponentToWorld.GetScale3D().GetAbs().GetMin()), KINDA_SMALL_NUMBER);
+
+    // 世界长度 / UV 比例只与缩放有关
+    if (!Entry.ComponentToWorld.GetScale3D().Equals(OldScale))
+    {
+        Entry.WorldUnitsPerU = 0.0f;
+    }
+}
+
+void UInkWorldSubsystem::AddToSpatialHash(const TObjectKey<UInkSystemComponent> &SurfaceKey, const FRegisteredSurface &Entry)
+{
+    if (Entry.bOversized)
+    {
+        OversizedSurfaces.Add(SurfaceKey);
+        return;
+    }
+
+    for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+    {
+        for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+        {
+            for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+            {
+                SpatialCells.FindOrAdd(FIntVector(X, Y, Z)).Add(SurfaceKey);
+            }
+        }
+    }
+}
+
+void UInkWorldSubsystem::RemoveFromSpatialHash(const TObjectKey<UInkSystemComponent> &SurfaceKey, const FRegisteredSurface &Entry)
+{
+    if (Entry.bOversized)
+    {
+        OversizedSurfaces.Remove(SurfaceKey);
+        return;
+    }
+
+    for (int32 Z = Entry.MinCell.Z; Z <= Entry.MaxCell.Z; ++Z)
+    {
+        for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+        {
+            for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+            {
+                const FIntVector Cell(X, Y, Z);
+                if (TArray<TObjectKey<UInkSystemComponent>> *CellSurfaces = SpatialCells.Find(Cell))
+                {
+                    CellSurfaces->RemoveSwap(SurfaceKey);
+                    if (CellSurfaces->IsEmpty())
+                    {
+                        SpatialCells.Remove(Cell);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void UInkWorldSubsystem::OnSurfaceTransformUpdated(USceneComponent *Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+    const UPrimitiveComponent *SurfacePrimitive = Cast<UPrimitiveComponent>(Component);
+    const TWeakObjectPtr<UInkSystemComponent> *Surface = SurfacePrimitive ? SurfacesByPrimitive.Find(SurfacePrimitive) : nullptr;
+    if (!Surface)
+    {
+        return;
+    }
+
+    const TObjectKey<UInkSystemComponent> SurfaceKey(Surface->Get());
+    FRegisteredSurface *Entry = RegisteredSurfaces.Find(SurfaceKey);
+    if (!Entry)
+    {
+        return;
+    }
+
+    // 格子范围可能改变，先按旧范围移除再按新范围加入
+    RemoveFromSpatialHash(SurfaceKey, *Entry);
+    UpdateSurfaceTransform(*Entry, SurfacePrimitive);
+    AddToSpatialHash(SurfaceKey, *Entry);
+}
+
+void UInkWorldSubsystem::RegisterPaintManager(APaintManager *Manager)
+{
+    if (PaintManager.IsValid() && PaintManager.Get() != Manager)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("InkWorldSubsystem: Multiple PaintManagers in level, using '%s'."), *GetNameSafe(Manager));
+    }
+
+    PaintManager = Manager;
+    bWarnedMissingPaintManager = false;
+}
+
+void UInkWorldSubsystem::UnregisterPaintManager(APaintManager *Manager)
+{
+    if (PaintManager.Get() == Manager)
+    {
+        PaintManager.Reset();
+    }
+}
+
+UInkSystemComponent *UInkWorldSubsystem::FindSurface(const UPrimitiveComponent *SurfacePrimitive) const
+{
+    if (const TWeakObjectPtr<UInkSystemComponent> *Found = SurfacesByPrimitive.Find(SurfacePrimitive))
+    {
+        return Found->Get();
+    }
+
+    return nullptr;
+}
+
+UInkSystemComponent *UInkWorldSubsystem::FindSurfaceById(uint32 SurfaceId) const
+{
+    const TWeakObjectPtr<UInkSystemComponent> *Found = SurfacesById.Find(SurfaceId);
+    return Found ? Found->Get() : nullptr;
+}
+
+bool UInkWorldSubsystem::GetSurfaceBounds(const UInkSystemComponent *Surface, FBox &OutBounds) const
+{
+    const FRegisteredSurface *Entry = RegisteredSurfaces.Find(Surface);
+    if (!Entry)
+    {
+        return false;
+    }
+
+    OutBounds = Entry->Bounds;
+    return true;
+}
+
+void UInkWorldSubsystem::GetRegisteredSurfaces(TArray<UInkSystemComponent *> &OutSurfaces) const
+{
+    OutSurfaces.Reset(SurfacesById.Num());
+    for (const TPair<uint32, TWeakObjectPtr<UInkSystemComponent>> &Pair : SurfacesById)
+    {
+        if (UInkSystemComponent *Surface = Pair.Value.Get())
+        {
+            OutSurfaces.Add(Surface);
+        }
+    }
+
+    OutSurfaces.Sort([](const UInkSystemComponent &A, const UInkSystemComponent &B)
+                     { return A.GetSurfaceId() < B.GetSurfaceId(); });
+}
+
+void UInkWorldSubsystem::QuerySurfaces(const FBox &Area, TArray<UInkSystemComponent *> &OutSurfaces) const
+{
+    OutSurfaces.Reset();
+
+    auto TestSurface = [this, &Area, &OutSurfaces](const TObjectKey<UInkSystemComponent> &SurfaceKey)
+    {
+        const FRegisteredSurface *Entry = RegisteredSurfaces.Find(SurfaceKey);
+        if (Entry && Entry->Bounds.Intersect(Area))
+        {
+            if (UInkSystemComponent *Surface = Entry->Surface.Get())
+            {
+                OutSurfaces.AddUnique(Surface);
+            }
+        }
+    };
+
+    for (const TObjectKey<UInkSystemComponent> &SurfaceKey : OversizedSurfaces)
+    {
+        TestSurface(SurfaceKey);
+    }
+
+    const FIntVector MinCell = ToCell(Area.Min);
+    const FIntVector MaxCell = ToCell(Area.Max);
+    for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+            {
+                if (const TArray<TObjectKey<UInkSystemComponent>> *CellSurfaces = SpatialCells.Find(FIntVector(X, Y, Z)))
+                {
+                    for (const TObjectKey<UInkSystemComponent> &SurfaceKey : *CellSurfaces)
+                    {
+                        TestSurface(SurfaceKey);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TSharedPtr<const FInkMeshUVData> UInkWorldSubsystem::GetMeshUVData(UStaticMesh *Mesh)
+{
+    if (!Mesh)
+    {
+        return nullptr;
+    }
+
+    // 失败的构建也会缓存为空指针，避免重复尝试
+    if (const TSharedPtr<const FInkMeshUVData> *Cached = MeshUVDataCache.Find(Mesh))
+    {
+        return *Cached;
+    }
+
+    return MeshUVDataCache.Add(Mesh, FInkMeshUVData::Build(Mesh));
+}
+
+bool UInkWorldSubsystem::ResolveSurfaceUV(const FVector &WorldLocation, const FVector &WorldNormal, UInkSystemComponent *&OutSurface, FVector2D &OutUV) const
+{
+    OutSurface = nullptr;
+
+    const FBox QueryBox = FBox(WorldLocation, WorldLocation).ExpandBy(LocationQueryTolerance);
+    float BestDistance = LocationQueryTolerance;
+
+    auto TestSurface = [&](const TObjectKey<UInkSystemComponent> &SurfaceKey)
+    {
+        const FRegisteredSurface *Entry = RegisteredSurfaces.Find(SurfaceKey);
+        if (!Entry || !Entry->Bounds.Intersect(QueryBox))
+        {
+            return;
+        }
+
+        FVector2D UV;
+        float Distance = 0.0f;
+        if (ProjectToSurface(*Entry, WorldLocation, WorldNormal, BestDistance, UV, Distance))
+        {
+            if (UInkSystemComponent *Surface = Entry->Surface.Get())
+            {
+                BestDistance = Distance;
+                OutSurface = Surface;
+                OutUV = UV;
+            }
+        }
+    };
+
+    for (const TObjectKey<UInkSystemComponent> &SurfaceKey : OversizedSurfaces)
+    {
+        TestSurface(SurfaceKey);
+    }
+
+    const FIntVector MinCell = ToCell(QueryBox.Min);
+    const FIntVector MaxCell = ToCell(QueryBox.Max);
+    for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+            {
+                if (const TArray<TObjectKey<UInkSystemComponent>> *CellSurfaces = SpatialCells.Find(FIntVector(X, Y, Z)))
+                {
+                    for (const TObjectKey<UInkSystemComponent> &SurfaceKey : *CellSurfaces)
+                    {
+                        TestSurface(SurfaceKey);
+                    }
+                }
+            }
+        }
+    }
+
+    return OutSurface != nullptr;
+}
+
+bool UInkWorldSubsystem::ProjectToSurface(const FRegisteredSurface &Entry, const FVector &WorldLocation, const FVector &WorldNormal, float MaxDistance, FVector2D &OutUV, float &OutDistance) const
+{
+    SCOPE_CYCLE_COUNTER(STAT_InkUVLookup);
+
+    if (!Entry.UVData.IsValid())
+    {
+        return false;
+    }
+
+    // 世界 -> 局部；法线按逆转置变换以支持非均匀缩放
+    const FVector3f LocalPoint(Entry.ComponentToWorld.InverseTransformPosition(WorldLocation));
+    const FVector3f LocalNormal(Entry.ComponentToWorld.InverseTransformVectorNoScale(WorldNormal) * Entry.ComponentToWorld.GetScale3D());
+
+    FVector2f UV;
+    float LocalDistance = 0.0f;
+    if (!Entry.UVData->FindUV(LocalPoint, LocalNormal, MaxDistance / Entry.MinScale, UV, &LocalDistance))
+    {
+        return false;
+    }
+
+    OutUV = FVector2D(UV);
+    OutDistance = LocalDistance * Entry.MinScale;
+    return true;
+}
+
+bool UInkWorldSubsystem::ComputeSurfaceUV(const UPrimitiveComponent *SurfacePrimitive, const FVector &WorldLocation, const FVector &WorldNormal, FVector2D &OutUV) const
+{
+    const TWeakObjectPtr<UInkSystemComponent> *Surface = SurfacesByPrimitive.Find(SurfacePrimitive);
+    const FRegisteredSurface *Entry = Surface ? RegisteredSurfaces.Find(Surface->Get()) : nullptr;
+    if (!Entry)
+    {
+        return false;
+    }
+
+    float Distance = 0.0f;
+    return ProjectToSurface(*Entry, WorldLocation, WorldNormal, LocationQueryTolerance, OutUV, Distance);
+}
+
+E_Team UInkWorldSubsystem::GetInkOwnerAtLocation(FVector WorldLocation, FVector WorldNormal) const
+{
+    UInkSystemComponent *Surface = nullptr;
+    FVector2D UV;
+    if (!ResolveSurfaceUV(WorldLocation, WorldNormal, Surface, UV))
+    {
+        return E_Team::None;
+    }
+
+    return Surface->GetInkOwnerAtUV(UV);
+}
+
+void UInkWorldSubsystem::GetInkOwnersAtLocations(const TArray<FVector> &WorldLocations, const TArray<FVector> &WorldNormals, TArray<E_Team> &OutOwners) const
+{
+    OutOwners.SetNumUninitialized(WorldLocations.Num());
+
+    const bool bPerPointNormals = WorldNormals.Num() == WorldLocations.Num();
+    const FVector SharedNormal = WorldNormals.Num() == 1 ? WorldNormals[0] : FVector::ZeroVector;
+
+    for (int32 Index = 0; Index < WorldLocations.Num(); ++Index)
+    {
+        OutOwners[Index] = GetInkOwnerAtLocation(WorldLocations[Index], bPerPointNormals ? WorldNormals[Index] : SharedNormal);
+    }
+}
+
+void UInkWorldSubsystem::ApplyCoverageDelta(const FInkCoverageDelta &Delta)
+{
+    for (int32 TeamIndex = 0; TeamIndex < InkMaxTeams; ++TeamIndex)
+    {
+        TeamTexels[TeamIndex] += Delta.Texels[TeamIndex];
+    }
+}
+
+int64 UInkWorldSubsystem::GetTeamTexelCount(E_Team Team) const
+{
+    const int32 TeamIndex = static_cast<int32>(Team) - 1;
+    return (TeamIndex >= 0 && TeamIndex < InkMaxTeams) ? TeamTexels[TeamIndex] : 0;
+}
+
+float UInkWorldSubsystem::GetTeamTerritoryRatio(E_Team Team) const
+{
+    return TotalTexels > 0 ? static_cast<float>(static_cast<double>(GetTeamTexelCount(Team)) / TotalTexels) : 0.0f;
+}
+
+bool UInkWorldSubsystem::PaintSurface(UPrimitiveComponent *SurfacePrimitive, FVector2D HitUV, E_Team Team, float BrushSize)
+{
+    // 射击目前不经过服务器，客户端仍在本地涂色；只有服务器上的涂色由 APaintManager 同步给其他端
+    UInkSystemComponent *Surface = FindSurface(SurfacePrimitive);
+    if (!Surface)
+    {
+        return false;
+    }
+
+    APaintManager *Manager = PaintManager.Get();
+    if (!Manager)
+    {
+        if (!bWarnedMissingPaintManager)
+        {
+            UE_LOG(LogTemp, Error, TEXT("InkWorldSubsystem: PaintManager not found in level!"));
+            bWarnedMissingPaintManager = true;
+        }
+        return false;
+    }
+
+    Manager->PaintTargetByTeam(Surface, HitUV, Team, BrushSize);
+    return true;
+}
+
+bool UInkWorldSubsystem::PaintAtLocation(UPrimitiveComponent *SurfacePrimitive, FVector WorldLocation, FVector WorldNormal, E_Team Team, float BrushSize, FVector2D &OutUV)
+{
+    // 命中点 -> UV 直接由网格 BVH 计算，无需二次复杂射线检测
+    if (!ComputeSurfaceUV(SurfacePrimitive, WorldLocation, WorldNormal, OutUV))
+    {
+        return false;
+    }
+
+    return PaintSurface(SurfacePrimitive, OutUV, Team, BrushSize);
+}
+
+int32 UInkWorldSubsystem::PaintSphere(const FVector &Center, float Radius, E_Team Team, TArray<UInkSystemComponent *> *OutSurfaces)
+{
+    SCOPE_CYCLE_COUNTER(STAT_InkSplat);
+
+    if (OutSurfaces)
+    {
+        OutSurfaces->Reset();
+    }
+
+    APaintManager *Manager = PaintManager.Get();
+    if (!Manager || Radius <= 0.0f || Team == E_Team::None)
+    {
+        return 0;
+    }
+
+    // 空间哈希 + 包围盒粗筛，再用球体与包围盒精确剔除
+    TArray<UInkSystemComponent *> Candidates;
+    QuerySurfaces(FBox(Center - FVector(Radius), Center + FVector(Radius)), Candidates);
+
+    const float RadiusSquared = FMath::Square(Radius);
+    int32 NumPainted = 0;
+
+    for (UInkSystemComponent *Surface : Candidates)
+    {
+        FRegisteredSurface *Entry = RegisteredSurfaces.Find(Surface);
+        if (!Entry || Entry->Bounds.ComputeSquaredDistanceToPoint(Center) > RadiusSquared)
+        {
+            continue;
+        }
+
+        // 球心到表面的最近点
+        FVector2D UV;
+        float Distance = 0.0f;
+        if (!ProjectToSurface(*Entry, Center, FVector::ZeroVector, Radius, UV, Distance))
+        {
+            continue;
+        }
+
+        if (Entry->WorldUnitsPerU == 0.0f)
+        {
+            float WorldArea = 0.0f;
+            float UVArea = 0.0f;
+            float Aspect = 1.0f;
+            const bool bValid = Entry->UVData->ComputeUVDensity(FVector3f(Entry->ComponentToWorld.GetScale3D().GetAbs()), WorldArea, UVArea, Aspect);
+
+            // U 长度 * V 长度 = WorldArea / UVArea，U 长度 / V 长度 = Aspect
+            Entry->WorldUnitsPerU = bValid ? FMath::Sqrt(WorldArea / UVArea * Aspect) : -1.0f;
+        }
+
+        if (Entry->WorldUnitsPerU < 0.0f)
+        {
+            continue;
+        }
+
+        // 球体在最近点处的截面半径 -> 该表面的画刷像素直径
+        const float SplatRadius = FMath::Sqrt(RadiusSquared - FMath::Square(Distance));
+        const float BrushSize = 2.0f * SplatRadius / Entry->WorldUnitsPerU * Surface->GetInkResolution().X;
+        if (BrushSize < 1.0f)
+        {
+            continue;
+        }
+
+        Manager->PaintTargetByTeam(Surface, UV, Team, BrushSize);
+        ++NumPainted;
+
+        if (OutSurfaces)
+        {
+            OutSurfaces->Add(Surface);
+        }
+    }
+
+    return NumPainted;
+}
+
+void UInkWorldSubsystem::RecordStamp(const FInkJournalEntry &Entry)
+{
+    if (!bReplayingJournal)
+    {
+        StampJournal.Record(Entry);
+    }
+}
+
+float UInkWorldSubsystem::GetServerTime() const
+{
+    const UWorld *World = GetWorld();
+    if (const AGameStateBase *GameState = World ? World->GetGameState() : nullptr)
+    {
+        return static_cast<float>(GameState->GetServerWorldTimeSeconds());
+    }
+
+    return World ? World->GetTimeSeconds() : 0.0f;
+}
+
+int32 UInkWorldSubsystem::ReplayJournal(TConstArrayView<FInkJournalEntry> Entries, bool bClearFirst)
+{
+    if (bClearFirst)
+    {
+        TArray<UInkSystemComponent *> Surfaces;
+        GetRegisteredSurfaces(Surfaces);
+        for (UInkSystemComponent *Surface : Surfaces)
+        {
+            Surface->ClearInk();
+        }
+    }
+
+    TGuardValue<bool> ReplayGuard(bReplayingJournal, true);
+    APaintManager *Manager = PaintManager.Get();
+
+    int32 NumReplayed = 0;
+    for (const FInkJournalEntry &Entry : Entries)
+    {
+        UInkSystemComponent *Surface = FindSurfaceById(Entry.SurfaceId);
+        if (!Surface)
+        {
+            continue;
+        }
+
+        const E_Team Team = static_cast<E_Team>(Entry.Team);
+        if (Manager)
+        {
+            Manager->PaintTargetByTeam(Surface, Entry.GetUV(), Team, Entry.GetBrushSize());
+        }
+        else
+        {
+            Surface->StampCoverage(Entry.GetUV(), Entry.GetBrushSize(), Team);
+        }
+        ++NumReplayed;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("InkWorldSubsystem: Replayed %d / %d journal entries."), NumReplayed, Entries.Num());
+    return NumReplayed;
+}
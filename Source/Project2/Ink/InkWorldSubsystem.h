@@ -0,0 +1,454 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Components/SceneComponent.h"
+#include "ShooterGameMode.h"
+#include "InkCoverageGrid.h"
+#include "InkStampJournal.h"
+#include "InkDecay.h"
+#include "InkEncoding.h"
+#include "InkWorldSubsystem.generated.h"
+
+class UInkSystemComponent;
+class UPrimitiveComponent;
+class UStaticMesh;
+class APaintManager;
+class UInkAtlas;
+class UTexture2D;
+struct FInkMeshUVData;
+
+/**
+ * 墨水系统的世界子系统
+ * 其他系统访问墨水系统的统一入口：
+ * - 维护可涂色表面的注册表（以网格组件为键）和空间哈希
+ * - 持有关卡中的 PaintManager 并负责涂色派发
+ * - 汇总各表面的队伍像素数，常数时间给出全局领地比例
+ * - 世界坐标 -> 表面 -> UV1 -> 归属的查询，不使用物理射线检测
+ * - 持有共享墨水图集（UInkAtlas），各表面从中分配 RenderTarget 区域
+ * - 按内存预算以 LRU 回收表面的 GPU 存储，被回收的表面重新可见时恢复
+ *
+ * 命中路径只需两次哈希查找，不再逐帧扫描关卡中的 Actor / 组件
+ */
+UCLASS(config = Game)
+class PROJECT2_API UInkWorldSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase &Collection) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+    // ========== 配置 ==========
+
+    /**
+     * 是否把各表面打包进共享图集（关闭时每个表面使用独占 RenderTarget）
+     * 需要表面材质按 CustomPrimitiveData 中的区域偏移 / 缩放采样，M_Inkable_Surface 更新前保持关闭
+     */
+    UPROPERTY(Config)
+    bool bUseInkAtlas = false;
+
+    /** 图集页边长（像素） */
+    UPROPERTY(Config)
+    int32 AtlasPageSize = 4096;
+
+    /** 图集中每个区域四周的边距（像素） */
+    UPROPERTY(Config)
+    int32 AtlasPadding = 2;
+
+    /** 墨水 RenderTarget 编码；PackedR8 显存减半，需要画刷与表面材质按 InkEncoding.h 中的约定实现 */
+    UPROPERTY(Config)
+    EInkTextureEncoding InkTextureEncoding = EInkTextureEncoding::TeamChannels;
+
+    /**
+     * 专属 RenderTarget 的内存预算（MB），超出时回收最久未使用的专属 RenderTarget 表面；0 表示不限制
+     * 图集页不计入预算：页在区域释放后不会归还，回收图集表面不能降低显存
+     */
+    UPROPERTY(Config)
+    int32 InkMemoryBudgetMB = 128;
+
+    /** 检查可见性（刷新 LRU 时间、恢复被回收表面）的间隔（秒） */
+    UPROPERTY(Config)
+    float ResidencyCheckInterval = 0.25f;
+
+    /** 每次检查最多恢复的表面数量，避免同一帧大量上传 */
+    UPROPERTY(Config)
+    int32 MaxRestoresPerCheck = 4;
+
+    /**
+     * 最近使用（涂色、可见、刚分配）后至少保留 GPU 存储的时间（秒）
+     * 大于可见性检查间隔时，仍可见的表面不会被回收，避免回收与恢复互相触发
+     */
+    UPROPERTY(Config)
+    float MinInkResidentTime = 1.0f;
+
+    /** 画刷日志容量（条目数，每条 16 字节），0 表示不记录 */
+    UPROPERTY(Config)
+    int32 JournalCapacity = 65536;
+
+    /** 是否启用墨水衰减（回收中立领地的模式，只在单机上生效），运行时可用 SetInkDecayEnabled 切换 */
+    UPROPERTY(Config)
+    bool bEnableInkDecay = false;
+
+    /** 墨水像素数减半所需的时间（秒） */
+    UPROPERTY(Config)
+    float InkDecayHalfLife = 60.0f;
+
+    /** 衰减分块的网格行数 */
+    UPROPERTY(Config)
+    int32 InkDecayTileRows = 32;
+
+    /** 每帧最多调度的衰减分块数 */
+    UPROPERTY(Config)
+    int32 InkDecayMaxTilesPerFrame = 16;
+
+    /** 游戏线程每帧用于衰减的预算（微秒） */
+    UPROPERTY(Config)
+    float InkDecayBudgetMicroseconds = 250.0f;
+
+    // ========== 注册 ==========
+
+    /** 注册可涂色表面（由 UInkSystemComponent::BeginPlay 调用） */
+    void RegisterSurface(UInkSystemComponent *Surface, UPrimitiveComponent *SurfacePrimitive);
+
+    /** 注销可涂色表面（由 UInkSystemComponent::EndPlay 调用） */
+    void UnregisterSurface(UInkSystemComponent *Surface);
+
+    /** 注册涂色管理器（由 APaintManager::BeginPlay 调用） */
+    void RegisterPaintManager(APaintManager *Manager);
+
+    /** 注销涂色管理器 */
+    void UnregisterPaintManager(APaintManager *Manager);
+
+    // ========== 查询 ==========
+
+    /** 根据被命中的网格组件查找其可涂色表面 */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    UInkSystemComponent *FindSurface(const UPrimitiveComponent *SurfacePrimitive) const;
+
+    /** 根据稳定 ID 查找可涂色表面（见 UInkSystemComponent::GetSurfaceId） */
+    UInkSystemComponent *FindSurfaceById(uint32 SurfaceId) const;
+
+    /** 获取所有已注册的表面，按表面 ID 排序 */
+    void GetRegisteredSurfaces(TArray<UInkSystemComponent *> &OutSurfaces) const;
+
+    /** 获取表面注册时的世界包围盒，未注册时返回 false */
+    bool GetSurfaceBounds(const UInkSystemComponent *Surface, FBox &OutBounds) const;
+
+    /** 查找包围盒与给定区域相交的所有可涂色表面 */
+    void QuerySurfaces(const FBox &Area, TArray<UInkSystemComponent *> &OutSurfaces) const;
+
+    /**
+     * 查询世界坐标处的墨水归属（角色移动、AI、HUD 等高频调用）
+     * 通过空间哈希找到表面，再用预计算的表面变换和网格 UV 数据映射到 UV1
+     * @param WorldLocation		世界坐标（通常是表面上或略高于表面的点）
+     * @param WorldNormal		表面法线，用于排除背面；传零向量表示不过滤
+     * @return					归属队伍，不在任何可涂色表面上时返回 None
+     */
+    UFUNCTION(BlueprintPure, Category = "Ink|Query")
+    E_Team GetInkOwnerAtLocation(FVector WorldLocation, FVector WorldNormal) const;
+
+    /**
+     * 批量版本的 GetInkOwnerAtLocation
+     * @param WorldLocations	世界坐标数组
+     * @param WorldNormals		法线数组；为空时不过滤，只有一个元素时对所有点使用同一法线
+     * @param OutOwners			每个点的归属队伍
+     */
+    UFUNCTION(BlueprintCallable, Category = "Ink|Query")
+    void GetInkOwnersAtLocations(const TArray<FVector> &WorldLocations, const TArray<FVector> &WorldNormals, TArray<E_Team> &OutOwners) const;
+
+    /**
+     * 将世界坐标解析为可涂色表面和 UV1
+     * @param WorldLocation		世界坐标
+     * @param WorldNormal		表面法线（零向量表示不过滤）
+     * @param OutSurface		命中的表面
+     * @param OutUV				对应的 UV1
+     * @return					是否在 LocationQueryTolerance 内找到表面
+     */
+    bool ResolveSurfaceUV(const FVector &WorldLocation, const FVector &WorldNormal, UInkSystemComponent *&OutSurface, FVector2D &OutUV) const;
+
+    /**
+     * 计算指定表面上某个世界坐标对应的 UV1（例如投射物命中点）
+     * @return	该组件已注册且点在 LocationQueryTolerance 内
+     */
+    bool ComputeSurfaceUV(const UPrimitiveComponent *SurfacePrimitive, const FVector &WorldLocation, const FVector &WorldNormal, FVector2D &OutUV) const;
+
+    /** 获取（必要时构建）网格资产的 UV 数据，同一网格的所有实例共享 */
+    TSharedPtr<const FInkMeshUVData> GetMeshUVData(UStaticMesh *Mesh);
+
+    /** 获取当前的涂色管理器 */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    APaintManager *GetPaintManager() const { return PaintManager.Get(); }
+
+    /** 获取共享墨水图集，未启用时返回 nullptr */
+    UInkAtlas *GetAtlas() const { return Atlas; }
+
+    /** 墨水 RenderTarget 编码（世界生命周期内固定） */
+    EInkTextureEncoding GetInkTextureEncoding() const { return InkTextureEncoding; }
+
+    /**
+     * 获取衰减逐行刷新共用的上传纹理（按 InkTextureEncoding 的像素格式），至少 Width x Height
+     * 只在尺寸不足时按 2 的幂重新创建，之后用 UpdateTextureRegions 更新区域，不再每次创建临时纹理
+     */
+    UTexture2D *AcquireInkUploadTexture(int32 Width, int32 Height);
+
+    /** 已注册的表面数量 */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    int32 GetNumSurfaces() const { return SurfacesByPrimitive.Num(); }
+
+    // ========== 领地统计 ==========
+
+    /** 累加某个表面写入造成的队伍像素变化（由 UInkSystemComponent::StampCoverage 调用） */
+    void ApplyCoverageDelta(const FInkCoverageDelta &Delta);
+
+    /** 指定队伍在所有已注册表面上的领地比例（0-1），常数时间 */
+    UFUNCTION(BlueprintPure, Category = "Ink|Territory")
+    float GetTeamTerritoryRatio(E_Team Team) const;
+
+    /** 指定队伍拥有的像素总数 */
+    int64 GetTeamTexelCount(E_Team Team) const;
+
+    /** 所有已注册表面的像素总数 */
+    int64 GetTotalTexels() const { return TotalTexels; }
+
+    // ========== GPU 存储预算 ==========
+
+    /**
+     * 为即将分配的专属 RenderTarget 腾出预算，按最近使用时间回收其他专属 RenderTarget 表面（图集表面不参与）
+     * 本帧涂过的表面和 MinInkResidentTime 内使用过的表面不会被回收，没有可回收的表面时暂时超出预算
+     * @param Bytes			即将分配的字节数
+     * @param Requester		发起分配的表面，不会被回收
+     */
+    void MakeRoomForInk(int64 Bytes, const UInkSystemComponent *Requester);
+
+    /** 表面分配了 GPU 存储（由 UInkSystemComponent::EnsureInkStorage 调用） */
+    void OnInkStorageAllocated(UInkSystemComponent *Surface);
+
+    /** 表面释放了 GPU 存储（由 UInkSystemComponent::ReleaseInkStorage 调用） */
+    void OnInkStorageReleased(UInkSystemComponent *Surface);
+
+    /** 未分配存储但归属网格有墨水的表面（例如由快照恢复），可见时恢复 */
+    void MarkSurfaceForRestore(UInkSystemComponent *Surface);
+
+    /** 当前常驻的专属 RenderTarget 字节数（计入预算的部分，不含图集页） */
+    int64 GetResidentInkBytes() const { return ResidentInkBytes; }
+
+    /** 拥有 GPU 存储的表面数量 */
+    int32 GetNumResidentSurfaces() const { return ResidentSurfaces.Num(); }
+
+    /** 被回收、只保留 CPU 归属网格的表面数量 */
+    int32 GetNumEvictedSurfaces() const { return EvictedSurfaces.Num(); }
+
+    // ========== 涂色派发 ==========
+
+    /**
+     * 在被命中的网格组件上涂色
+     * @param SurfacePrimitive	被命中的网格组件
+     * @param HitUV				命中的 UV 坐标（0-1 范围）
+     * @param Team				队伍
+     * @param BrushSize			画刷大小（像素），默认使用 PaintManager 的 DefaultBrushSize
+     * @return					是否找到表面并派发了涂色
+     */
+    UFUNCTION(BlueprintCallable, Category = "Ink")
+    bool PaintSurface(UPrimitiveComponent *SurfacePrimitive, FVector2D HitUV, E_Team Team, float BrushSize = 0.0f);
+
+    /**
+     * 在被命中网格的世界坐标处涂色（命中点 -> UV 由网格 BVH 直接计算）
+     * @param SurfacePrimitive	被命中的网格组件
+     * @param WorldLocation		命中点
+     * @param WorldNormal		命中法线
+     * @param Team				队伍
+     * @param BrushSize			画刷大小（像素），默认使用 PaintManager 的 DefaultBrushSize
+     * @param OutUV				命中点对应的 UV1
+     * @return					是否派发了涂色
+     */
+    UFUNCTION(BlueprintCallable, Category = "Ink")
+    bool PaintAtLocation(UPrimitiveComponent *SurfacePrimitive, FVector WorldLocation, FVector WorldNormal, E_Team Team, float BrushSize, FVector2D &OutUV);
+
+    /**
+     * 在世界空间球体范围内涂色，覆盖所有与之相交的可涂色表面（墙角、接缝、相邻网格）
+     * 通过空间哈希和包围盒剔除候选表面，再找到每个表面上离球心最近的点，
+     * 以球体在该处的截面半径 sqrt(R² - d²) 换算为该表面的画刷像素大小，一次性派发
+     * 每个表面只在最近点处落一个圆形画刷；同一网格跨 UV 分块的接缝不会被拆分
+     * @param Center			球心（通常为命中点）
+     * @param Radius			半径（cm）
+     * @param Team				队伍
+     * @param OutSurfaces		可选，被涂色的表面
+     * @return					被涂色的表面数量
+     */
+    int32 PaintSphere(const FVector &Center, float Radius, E_Team Team, TArray<UInkSystemComponent *> *OutSurfaces = nullptr);
+
+    /** 蓝图版本的 PaintSphere */
+    UFUNCTION(BlueprintCallable, Category = "Ink", meta = (DisplayName = "Paint Sphere"))
+    int32 K2_PaintSphere(FVector Center, float Radius, E_Team Team) { return PaintSphere(Center, Radius, Team); }
+
+    // ========== 画刷日志 ==========
+
+    /** 记录一次涂色（由 APaintManager::PaintTarget 调用，回放期间忽略） */
+    void RecordStamp(const FInkJournalEntry &Entry);
+
+    /** 获取画刷日志 */
+    const FInkStampJournal &GetStampJournal() const { return StampJournal; }
+
+    /**
+     * 回放画刷日志，按顺序重新涂色（有 PaintManager 时同时绘制 GPU，否则只重建归属网格）
+     * @param Entries		按时间顺序排列的条目
+     * @param bClearFirst	回放前是否清空所有表面
+     * @return				成功回放的条目数（找不到表面的条目被跳过）
+     */
+    int32 ReplayJournal(TConstArrayView<FInkJournalEntry> Entries, bool bClearFirst);
+
+    /** 当前服务器时间（秒），没有 GameState 时使用世界时间 */
+    float GetServerTime() const;
+
+    // ========== 衰减 ==========
+
+    /**
+     * 开启或关闭墨水衰减
+     * 衰减结果不同步给客户端、也不写入画刷日志，联机时拒绝开启
+     */
+    UFUNCTION(BlueprintCallable, Category = "Ink")
+    void SetInkDecayEnabled(bool bEnabled);
+
+    /** 墨水衰减是否实际运行（配置开启且为单机） */
+    UFUNCTION(BlueprintPure, Category = "Ink")
+    bool IsInkDecayEnabled() const;
+
+protected:
+    /** 已注册的表面信息 */
+    struct FRegisteredSurface
+    {
+        TWeakObjectPtr<UInkSystemComponent> Surface;
+        TObjectKey<UPrimitiveComponent> Primitive;
+        FBox Bounds = FBox(ForceInit);
+
+        /** 覆盖的空间哈希格子范围（超大表面不入哈希，见 OversizedSurfaces） */
+        FIntVector MinCell = FIntVector::ZeroValue;
+        FIntVector MaxCell = FIntVector::ZeroValue;
+        bool bOversized = false;
+
+        /** 缓存的组件变换，组件移动时由 OnSurfaceTransformUpdated 刷新 */
+        FTransform ComponentToWorld;
+
+        /** 组件最小缩放，用于把世界距离换算到局部空间 */
+        float MinScale = 1.0f;
+
+        /** 共享的网格 UV 数据 */
+        TSharedPtr<const FInkMeshUVData> UVData;
+
+        /** U 方向每 UV 单位对应的世界长度（cm），首次球形涂色时计算，0 表示尚未计算（缩放变化后重新计算），负数表示无法计算 */
+        float WorldUnitsPerU = 0.0f;
+    };
+
+    /** 空间哈希格子边长（cm） */
+    static constexpr float SpatialCellSize = 1000.0f;
+
+    /** 位置查询允许点偏离表面的最大距离（cm） */
+    static constexpr float LocationQueryTolerance = 20.0f;
+
+    /** 单个表面最多占用的格子数，超过则放入 OversizedSurfaces */
+    static constexpr int32 MaxCellsPerSurface = 512;
+
+    /** 网格组件 -> 可涂色表面 */
+    TMap<TObjectKey<UPrimitiveComponent>, TWeakObjectPtr<UInkSystemComponent>> SurfacesByPrimitive;
+
+    /** 可涂色表面 -> 注册信息 */
+    TMap<TObjectKey<UInkSystemComponent>, FRegisteredSurface> RegisteredSurfaces;
+
+    /** 稳定 ID -> 可涂色表面 */
+    TMap<uint32, TWeakObjectPtr<UInkSystemComponent>> SurfacesById;
+
+    /** 空间哈希：格子坐标 -> 与之相交的表面 */
+    TMap<FIntVector, TArray<TObjectKey<UInkSystemComponent>>> SpatialCells;
+
+    /** 占用格子过多的表面（例如巨大的地板），查询时总是参与测试 */
+    TArray<TObjectKey<UInkSystemComponent>> OversizedSurfaces;
+
+    /** 所有已注册表面的像素总数 */
+    int64 TotalTexels = 0;
+
+    /** 各队伍在所有已注册表面上的像素数（下标为队伍编码 - 1） */
+    int64 TeamTexels[InkMaxTeams] = {};
+
+    /** 网格资产 -> 共享 UV 数据 */
+    TMap<TObjectKey<UStaticMesh>, TSharedPtr<const FInkMeshUVData>> MeshUVDataCache;
+
+    /** 当前关卡中的涂色管理器 */
+    TWeakObjectPtr<APaintManager> PaintManager;
+
+    /** 共享墨水图集 */
+    UPROPERTY()
+    TObjectPtr<UInkAtlas> Atlas;
+
+    /** 衰减刷新共用的上传纹理，见 AcquireInkUploadTexture */
+    UPROPERTY(Transient)
+    TObjectPtr<UTexture2D> InkUploadTexture;
+
+    /** 拥有 GPU 存储的表面 */
+    TArray<TWeakObjectPtr<UInkSystemComponent>> ResidentSurfaces;
+
+    /** 被回收且有墨水的表面，重新可见时恢复 */
+    TArray<TWeakObjectPtr<UInkSystemComponent>> EvictedSurfaces;
+
+    /** 常驻 GPU 存储的字节数 */
+    int64 ResidentInkBytes = 0;
+
+    /** 距下一次可见性检查的剩余时间 */
+    float ResidencyCheckTimer = 0.0f;
+
+    /** 画刷日志 */
+    FInkStampJournal StampJournal;
+
+    /** 更新 stat Ink 和 CSV 分析器中的每帧统计 */
+    void RecordFrameStats() const;
+
+    /** 分时衰减调度 */
+    FInkDecayScheduler DecayScheduler;
+
+    /** 当前世界能否运行衰减（只支持单机） */
+    bool CanRunInkDecay() const;
+
+    /** 正在回放日志，期间不记录 */
+    bool bReplayingJournal = false;
+
+    /** 正在回收中，避免 ReleaseInkStorage 回调重复处理 */
+    bool bEvicting = false;
+
+    /** 刷新常驻表面的使用时间，恢复重新可见的被回收表面 */
+    void UpdateResidency();
+
+    /** 是否已提示过缺少 PaintManager */
+    bool bWarnedMissingPaintManager = false;
+
+    /** 将世界坐标投影到已注册表面并求 UV */
+    bool ProjectToSurface(const FRegisteredSurface &Entry, const FVector &WorldLocation, const FVector &WorldNormal, float MaxDistance, FVector2D &OutUV, float &OutDistance) const;
+
+    /** 世界坐标 -> 格子坐标 */
+    static FIntVector ToCell(const FVector &Location);
+
+    /** 表面计入预算的字节数（图集表面为 0） */
+    static int64 GetBudgetedInkBytes(const UInkSystemComponent &Surface);
+
+    /** 按组件当前的变换和包围盒刷新表面记录中的缓存（不修改空间哈希） */
+    static void UpdateSurfaceTransform(FRegisteredSurface &Entry, const UPrimitiveComponent *SurfacePrimitive);
+
+    /** 把表面加入空间哈希（超大表面放入 OversizedSurfaces） */
+    void AddToSpatialHash(const TObjectKey<UInkSystemComponent> &SurfaceKey, const FRegisteredSurface &Entry);
+
+    /** 把表面从空间哈希中移除 */
+    void RemoveFromSpatialHash(const TObjectKey<UInkSystemComponent> &SurfaceKey, const FRegisteredSurface &Entry);
+
+    /** 可涂色表面移动后刷新缓存的变换、包围盒和空间哈希 */
+    void OnSurfaceTransformUpdated(USceneComponent *Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+};
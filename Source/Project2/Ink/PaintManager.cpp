@@ -2,21 +2,63 @@
 
 #include "PaintManager.h"
 #include "InkSystemComponent.h"
+#include "InkWorldSubsystem.h"
+#include "InkStats.h"
+#include "ShooterPlayerController.h"
+#include "Engine/World.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Engine/Canvas.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Kismet/KismetRenderingLibrary.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
 
 APaintManager::APaintManager()
 {
-    PrimaryActorTick.bCanEverTick = false;
+    // 在所有 Actor 更新完毕后刷新画刷队列
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+    // 只复制表面 ID 表，画刷本身经玩家控制器的 RPC 按连接发送
+    bReplicates = true;
+    bAlwaysRelevant = true;
+}
+
+void APaintManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(APaintManager, NetSurfaceIds);
 }
 
 void APaintManager::BeginPlay()
 {
     Super::BeginPlay();
 
+    // 画刷材质参数取决于子系统配置的编码，需先获取子系统
+    InkSubsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(GetWorld());
+
     InitializeBrushMaterial();
+
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->RegisterPaintManager(this);
+    }
+}
+
+void APaintManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // 绘制尚未刷新的画刷
+    FlushPendingStamps();
+    NetClients.Reset();
+
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->UnregisterPaintManager(this);
+        InkSubsystem.Reset();
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void APaintManager::InitializeBrushMaterial()
@@ -30,18 +72,44 @@ void APaintManager::InitializeBrushMaterial()
     // 创建画刷材质的动态实例
     BrushMatInst = UMaterialInstanceDynamic::Create(BrushSourceMaterial, this);
 
-    if (BrushMatInst)
+    if (!BrushMatInst)
     {
-        UE_LOG(LogTemp, Log, TEXT("PaintManager: Brush Material Instance created successfully."));
+        UE_LOG(LogTemp, Error, TEXT("PaintManager: Failed to create Brush Material Instance!"));
+        return;
     }
-    else
+
+    const EInkTextureEncoding Encoding = InkSubsystem.IsValid() ? InkSubsystem->GetInkTextureEncoding() : EInkTextureEncoding::TeamChannels;
+
+    // 每个队伍一份实例：同一 Canvas 批次内材质参数只在渲染时读取，无法逐次修改共享实例
+    TeamBrushMatInsts.Reset();
+    for (int32 TeamIndex = 1; TeamIndex <= InkMaxTeams; ++TeamIndex)
     {
-        UE_LOG(LogTemp, Error, TEXT("PaintManager: Failed to create Brush Material Instance!"));
+        UMaterialInstanceDynamic *TeamMatInst = (TeamIndex == 1) ? BrushMatInst.Get() : UMaterialInstanceDynamic::Create(BrushSourceMaterial, this);
+        if (TeamMatInst)
+        {
+            // 两种编码的参数都设置，材质按 "InkEncoding" 选择（约定见 InkEncoding.h）
+            TeamMatInst->SetScalarParameterValue(FName(TEXT("InkEncoding")), InkEncoding::GetMaterialSwitch(Encoding));
+            TeamMatInst->SetScalarParameterValue(FName(TEXT("TeamID")), TeamToFloat(static_cast<E_Team>(TeamIndex)));
+            TeamMatInst->SetScalarParameterValue(FName(TEXT("InkPaletteBase")), InkEncoding::GetPaletteBase(TeamIndex) / 255.0f);
+        }
+        TeamBrushMatInsts.Add(TeamMatInst);
     }
+
+    UE_LOG(LogTemp, Log, TEXT("PaintManager: Brush Material Instances created successfully."));
+}
+
+void APaintManager::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    FlushPendingStamps();
+    SendNetStamps();
 }
 
 void APaintManager::PaintTarget(UInkSystemComponent *TargetComp, FVector2D HitUV, float TeamID, float BrushSize)
 {
+    SCOPE_CYCLE_COUNTER(STAT_InkStampQueue);
+
     // 1. 验证输入
     if (!TargetComp)
     {
@@ -49,12 +117,63 @@ void APaintManager::PaintTarget(UInkSystemComponent *TargetComp, FVector2D HitUV
         return;
     }
 
+    // 2. 使用默认画刷大小（如果未指定）
+    if (BrushSize <= 0.0f)
+    {
+        BrushSize = DefaultBrushSize;
+    }
+
+    // 3. 量化并记录到画刷日志；实际涂色、网络同步和日志回放都使用量化后的值，涂色的像素完全一致
+    const E_Team Team = FloatToTeam(TeamID);
+    if (Team == E_Team::None)
+    {
+        return;
+    }
+    BrushSize = FMath::Min(BrushSize, FInkNetStamp::MaxBrushSize);
+
+    const FInkJournalEntry JournalEntry = FInkJournalEntry::Make(
+        TargetComp->GetSurfaceId(),
+        HitUV,
+        static_cast<uint8>(Team),
+        BrushSize,
+        InkSubsystem.IsValid() ? InkSubsystem->GetServerTime() : GetWorld()->GetTimeSeconds());
+    HitUV = JournalEntry.GetUV();
+    BrushSize = JournalEntry.GetBrushSize();
+
+    if (InkSubsystem.IsValid())
+    {
+        InkSubsystem->RecordStamp(JournalEntry);
+    }
+
+    InkStats::TraceStamp(JournalEntry);
+    INC_DWORD_STAT(STAT_InkStampsPerFrame);
+    ++PendingCounters.StampsPainted;
+    if (TargetComp->GetLastPaintFrame() != GFrameCounter)
+    {
+        INC_DWORD_STAT(STAT_InkSurfacesPainted);
+        ++PendingCounters.SurfacesPainted;
+    }
+
+    if (IsNetServer())
+    {
+        QueueNetStamp(TargetComp, JournalEntry);
+    }
+
+    // 4. 先更新 CPU 归属网格（不依赖 RenderTarget，-nullrhi 下也能保持归属正确）
+    TargetComp->StampCoverage(HitUV, BrushSize, Team);
+
     if (!BrushMatInst)
     {
         UE_LOG(LogTemp, Warning, TEXT("PaintManager::PaintTarget: BrushMatInst is null! Did you assign BrushSourceMaterial?"));
         return;
     }
 
+    // GPU 存储在首次涂色时分配（专用服务器上不分配，只维护 CPU 归属网格）
+    if (!TargetComp->EnsureInkStorage())
+    {
+        return;
+    }
+
     UTextureRenderTarget2D *RenderTarget = TargetComp->GetRenderTarget();
     if (!RenderTarget)
     {
@@ -62,51 +181,442 @@ void APaintManager::PaintTarget(UInkSystemComponent *TargetComp, FVector2D HitUV
         return;
     }
 
-    // 2. 使用默认画刷大小（如果未指定）
-    if (BrushSize <= 0.0f)
+    // 5. 计算像素坐标（UV 0-1 转换为表面在 RenderTarget 中所占区域的像素坐标）
+    const FIntRect &InkRect = TargetComp->GetInkRect();
+    const FVector2D PixelCenter = FVector2D(InkRect.Min) + HitUV * FVector2D(InkRect.Size());
+
+    // 6. 加入帧末批次，由 FlushPendingStamps 统一绘制
+    QueueStamp(RenderTarget, InkRect, PixelCenter, BrushSize, Team);
+}
+
+void APaintManager::QueueStamp(UTextureRenderTarget2D *RenderTarget, const FIntRect &ClipRect, const FVector2D &PixelCenter, float BrushSize, E_Team Team)
+{
+    const int32 TeamIndex = static_cast<int32>(Team) - 1;
+    if (TeamIndex < 0 || TeamIndex >= InkMaxTeams)
     {
-        BrushSize = DefaultBrushSize;
+        return;
     }
 
-    // 3. 计算像素坐标（UV 0-1 转换为像素坐标）
-    const int32 Resolution = TargetComp->GetResolution();
-    const float PixelX = HitUV.X * Resolution;
-    const float PixelY = HitUV.Y * Resolution;
+    ++PendingCounters.StampsQueued;
+
+    FPendingStampBatch &Batch = PendingBatches.FindOrAdd(RenderTarget);
+    Batch.RenderTarget = RenderTarget;
+
+    // 合并键：队伍 + 中心像素坐标
+    const uint64 PixelX = static_cast<uint32>(FMath::FloorToInt32(PixelCenter.X)) & 0xFFFFFF;
+    const uint64 PixelY = static_cast<uint32>(FMath::FloorToInt32(PixelCenter.Y)) & 0xFFFFFF;
+    const uint64 MergeKey = (static_cast<uint64>(TeamIndex) << 48) | (PixelY << 24) | PixelX;
+
+    // 队伍变化时开始新的一段，之前的画刷不再参与合并
+    if (!Batch.Stamps.IsEmpty() && Batch.Stamps.Last().TeamIndex != TeamIndex)
+    {
+        Batch.RunStart = Batch.Stamps.Num();
+    }
+
+    const int32 *ExistingIndex = Batch.StampIndexByKey.Find(MergeKey);
+    if (ExistingIndex && *ExistingIndex >= Batch.RunStart)
+    {
+        // 同一段内同一像素上的重复画刷只保留最大的一次（同心画刷，较大的覆盖较小的）
+        FPendingStamp &Existing = Batch.Stamps[*ExistingIndex];
+        Existing.Size = FMath::Max(Existing.Size, BrushSize);
+        ++PendingCounters.StampsMerged;
+        return;
+    }
+
+    Batch.StampIndexByKey.Add(MergeKey, Batch.Stamps.Add({PixelCenter, BrushSize, ClipRect, TeamIndex}));
+}
+
+void APaintManager::FlushPendingStamps()
+{
+    SCOPE_CYCLE_COUNTER(STAT_InkFlush);
+
+    for (TPair<TObjectKey<UTextureRenderTarget2D>, FPendingStampBatch> &Pair : PendingBatches)
+    {
+        FPendingStampBatch &Batch = Pair.Value;
+        UTextureRenderTarget2D *RenderTarget = Batch.RenderTarget.Get();
+        if (!RenderTarget)
+        {
+            continue;
+        }
+
+        // 每个脏 RenderTarget 只做一次 Canvas 绘制
+        UCanvas *Canvas = nullptr;
+        FVector2D CanvasSize;
+        FDrawToRenderTargetContext Context;
+
+        UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(
+            this,
+            RenderTarget,
+            Canvas,
+            CanvasSize,
+            Context);
 
-    // 画刷居中绘制
-    const float DrawX = PixelX - (BrushSize * 0.5f);
-    const float DrawY = PixelY - (BrushSize * 0.5f);
+        if (Canvas)
+        {
+            // 按调用顺序绘制，队伍变化时切换画刷材质，与 CPU 归属网格的覆盖顺序一致
+            int32 CurrentTeamIndex = INDEX_NONE;
+            UMaterialInstanceDynamic *TeamMatInst = nullptr;
 
-    // 4. 设置队伍 ID 参数
-    BrushMatInst->SetScalarParameterValue(FName(TEXT("TeamID")), TeamID);
+            for (const FPendingStamp &Stamp : Batch.Stamps)
+            {
+                if (Stamp.TeamIndex != CurrentTeamIndex)
+                {
+                    CurrentTeamIndex = Stamp.TeamIndex;
+                    TeamMatInst = GetTeamBrushMaterial(static_cast<E_Team>(CurrentTeamIndex + 1));
+                }
 
-    // 5. 使用 Canvas 绘制到 Render Target
-    UCanvas *Canvas = nullptr;
-    FVector2D CanvasSize;
-    FDrawToRenderTargetContext Context;
+                if (!TeamMatInst)
+                {
+                    continue;
+                }
 
-    UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(
-        this,
-        RenderTarget,
-        Canvas,
-        CanvasSize,
-        Context);
+                // 画刷居中绘制，并裁剪到表面区域内
+                const FVector2D StampMin = Stamp.Center - FVector2D(Stamp.Size * 0.5f);
+                const FVector2D ClipMin = FVector2D::Max(StampMin, FVector2D(Stamp.ClipRect.Min));
+                const FVector2D ClipMax = FVector2D::Min(StampMin + FVector2D(Stamp.Size), FVector2D(Stamp.ClipRect.Max));
+                if (ClipMax.X <= ClipMin.X || ClipMax.Y <= ClipMin.Y)
+                {
+                    continue;
+                }
 
-    if (Canvas)
+                Canvas->K2_DrawMaterial(
+                    TeamMatInst,
+                    ClipMin,                                 // 位置
+                    ClipMax - ClipMin,                       // 大小
+                    (ClipMin - StampMin) / Stamp.Size,       // UV 起点
+                    (ClipMax - ClipMin) / Stamp.Size,        // UV 范围（裁剪后的部分材质）
+                    0.0f,                                    // 旋转
+                    FVector2D(0.5f, 0.5f)                    // 旋转中心
+                );
+                ++PendingCounters.StampsFlushed;
+            }
+            ++PendingCounters.CanvasPasses;
+        }
+
+        UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+    }
+
+    PendingBatches.Reset();
+
+    // 更新计数
+    LastFlushCounters = PendingCounters;
+    TotalCounters.StampsPainted += PendingCounters.StampsPainted;
+    TotalCounters.SurfacesPainted += PendingCounters.SurfacesPainted;
+    TotalCounters.StampsQueued += PendingCounters.StampsQueued;
+    TotalCounters.StampsMerged += PendingCounters.StampsMerged;
+    TotalCounters.StampsFlushed += PendingCounters.StampsFlushed;
+    TotalCounters.CanvasPasses += PendingCounters.CanvasPasses;
+    PendingCounters = FInkStampCounters();
+}
+
+bool APaintManager::IsNetServer() const
+{
+    const ENetMode NetMode = GetNetMode();
+    return NetMode == NM_DedicatedServer || NetMode == NM_ListenServer;
+}
+
+void APaintManager::QueueNetStamp(UInkSystemComponent *TargetComp, const FInkJournalEntry &Entry)
+{
+    if (NetClients.IsEmpty())
     {
-        // 绘制画刷材质到 Canvas
-        Canvas->K2_DrawMaterial(
-            BrushMatInst,
-            FVector2D(DrawX, DrawY),         // 位置
-            FVector2D(BrushSize, BrushSize), // 大小
-            FVector2D(0.0f, 0.0f),           // UV 起点
-            FVector2D(1.0f, 1.0f),           // UV 终点（整个材质）
-            0.0f,                            // 旋转
-            FVector2D(0.5f, 0.5f)            // 旋转中心
-        );
+        return;
     }
 
-    UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+    const uint16 *SurfaceIndex = NetIndexBySurfaceId.Find(Entry.SurfaceId);
+    if (!SurfaceIndex)
+    {
+        // 下标表已满：该表面改为定期以快照同步
+        if (NetSurfaceIds.Num() >= NetMaxSurfaceIds)
+        {
+            for (FNetClient &Client : NetClients)
+            {
+                Client.OverflowSurfaces.Add(TargetComp);
+            }
+            return;
+        }
+
+        SurfaceIndex = &NetIndexBySurfaceId.Add(Entry.SurfaceId, static_cast<uint16>(NetSurfaceIds.Add(Entry.SurfaceId)));
+    }
+
+    // 画刷大小原样使用日志的量化值
+    FInkNetStamp Stamp;
+    Stamp.SurfaceIndex = *SurfaceIndex;
+    Stamp.U = Entry.U;
+    Stamp.V = Entry.V;
+    Stamp.Team = Entry.Team;
+    Stamp.BrushSize = Entry.BrushSize;
+
+    FBox Bounds;
+    const bool bHasBounds = InkSubsystem.IsValid() && InkSubsystem->GetSurfaceBounds(TargetComp, Bounds);
+    const float NearDistanceSquared = FMath::Square(NetNearDistance);
+
+    for (FNetClient &Client : NetClients)
+    {
+        // 已有画刷在远处队列中的表面继续进入远处队列，保证同一表面的画刷按顺序应用
+        bool bFar = Client.FarSurfaces.Contains(Stamp.SurfaceIndex);
+        if (!bFar && bHasBounds)
+        {
+            bFar = Bounds.ComputeSquaredDistanceToPoint(Client.ViewLocation) > NearDistanceSquared;
+        }
+
+        if (bFar)
+        {
+            Client.FarStamps.Add(Stamp);
+            Client.FarSurfaces.Add(Stamp.SurfaceIndex);
+        }
+        else
+        {
+            Client.NearStamps.Add(Stamp);
+        }
+    }
+}
+
+void APaintManager::SendNetStamps()
+{
+    SCOPE_CYCLE_COUNTER(STAT_InkNetSend);
+
+    if (!IsNetServer())
+    {
+        return;
+    }
+
+    UWorld *World = GetWorld();
+    const double Now = World->GetTimeSeconds();
+
+    // 同步连接列表：移除已断开的玩家，为新加入的远程玩家准备完整快照
+    NetClients.RemoveAll([](const FNetClient &Client)
+                         { return !Client.Controller.IsValid(); });
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        AShooterPlayerController *Controller = Cast<AShooterPlayerController>(It->Get());
+        if (!Controller || Controller->IsLocalController())
+        {
+            continue;
+        }
+
+        if (NetClients.ContainsByPredicate([Controller](const FNetClient &Client)
+                                           { return Client.Controller == Controller; }))
+        {
+            continue;
+        }
+
+        FNetClient &Client = NetClients.AddDefaulted_GetRef();
+        Client.Controller = Controller;
+        Client.NextFarSendTime = Now + NetFarSendInterval;
+
+        // 空白表面无需发送；快照在发送时逐个表面捕获，之后的画刷都会进入该连接的队列
+        TArray<UInkSystemComponent *> Surfaces;
+        if (InkSubsystem.IsValid())
+        {
+            InkSubsystem->GetRegisteredSurfaces(Surfaces);
+        }
+        Surfaces.RemoveAll([](const UInkSystemComponent *Surface)
+                           { return !Surface->HasAnyInk(); });
+        if (!Surfaces.IsEmpty())
+        {
+            Client.SnapshotWriter = MakeUnique<FInkSnapshotWriter>(Surfaces);
+        }
+    }
+
+    for (FNetClient &Client : NetClients)
+    {
+        AShooterPlayerController *Controller = Client.Controller.Get();
+
+        FRotator ViewRotation;
+        Controller->GetPlayerViewPoint(Client.ViewLocation, ViewRotation);
+
+        // 远处队列到期后接到近处队列末尾，共用同一个发送上限
+        if (Now >= Client.NextFarSendTime)
+        {
+            Client.NearStamps.Append(Client.FarStamps);
+            Client.FarStamps.Reset();
+            Client.FarSurfaces.Reset();
+            Client.NextFarSendTime = Now + NetFarSendInterval;
+
+            // 没有下标的表面随远处队列一起以快照发送（上一份快照发完之后）
+            if (!Client.SnapshotWriter && !Client.OverflowSurfaces.IsEmpty())
+            {
+                TArray<UInkSystemComponent *> Surfaces;
+                for (const TWeakObjectPtr<UInkSystemComponent> &Surface : Client.OverflowSurfaces)
+                {
+                    if (Surface.IsValid())
+                    {
+                        Surfaces.Add(Surface.Get());
+                    }
+                }
+                Client.OverflowSurfaces.Reset();
+
+                if (!Surfaces.IsEmpty())
+                {
+                    Client.SnapshotWriter = MakeUnique<FInkSnapshotWriter>(Surfaces);
+                }
+            }
+        }
+
+        // 快照与画刷走同一个可靠通道，按发送顺序到达
+        SendNetSnapshotChunk(Client, Now);
+
+        SendNetStampBatch(Client, Now);
+    }
+}
+
+void APaintManager::SendNetSnapshotChunk(FNetClient &Client, double Now)
+{
+    // 可靠 RPC 没有流控，按每连接的字节预算摊开发送，避免占满可靠缓冲
+    if (!Client.SnapshotWriter || Now < Client.NextSnapshotSendTime)
+    {
+        return;
+    }
+
+    TArray<uint8> Chunk;
+    if (!Client.SnapshotWriter->WriteChunk(Chunk, NetSnapshotChunkBytes))
+    {
+        Client.SnapshotWriter.Reset();
+    }
+
+    // 剩余表面都已失效或没有内容时只剩块头
+    if (Chunk.Num() <= FInkSnapshot::HeaderSize)
+    {
+        return;
+    }
+
+    Client.Controller->ClientReceiveInkSnapshot(Chunk);
+    Client.Rate.Add(Chunk.Num(), Now);
+    Client.NextSnapshotSendTime = Now + static_cast<double>(Chunk.Num()) / FMath::Max(NetSnapshotBytesPerSecond, 1);
+}
+
+void APaintManager::SendNetStampBatch(FNetClient &Client, double Now)
+{
+    if (Client.NearStamps.IsEmpty())
+    {
+        return;
+    }
+
+    const int32 NumStamps = FMath::Min(Client.NearStamps.Num(), NetMaxStampsPerRPC);
+
+    TArray<uint8> Packed;
+    Packed.Reserve(NumStamps * FInkNetStamp::PackedSize);
+    for (int32 Index = 0; Index < NumStamps; ++Index)
+    {
+        Client.NearStamps[Index].Pack(Packed);
+    }
+    Client.NearStamps.RemoveAt(0, NumStamps, EAllowShrinking::No);
+
+    Client.Controller->ClientReceiveInkStamps(Packed);
+    Client.Rate.Add(Packed.Num(), Now);
+}
+
+void APaintManager::ReceiveNetStamps(const TArray<uint8> &PackedStamps)
+{
+    ReceiveRate.Add(PackedStamps.Num(), GetWorld()->GetTimeSeconds());
+
+    const int32 NumStamps = PackedStamps.Num() / FInkNetStamp::PackedSize;
+    for (int32 Index = 0; Index < NumStamps; ++Index)
+    {
+        const FInkNetStamp Stamp = FInkNetStamp::Unpack(PackedStamps.GetData() + Index * FInkNetStamp::PackedSize);
+
+        // 前面已有画刷在等待表面 ID 表时，后续画刷也排队，保持顺序
+        if (!DeferredNetStamps.IsEmpty() || !ApplyNetStamp(Stamp))
+        {
+            DeferredNetStamps.Add(Stamp);
+        }
+    }
+}
+
+void APaintManager::ReceiveNetSnapshot(const TArray<uint8> &Chunk)
+{
+    ReceiveRate.Add(Chunk.Num(), GetWorld()->GetTimeSeconds());
+
+    if (InkSubsystem.IsValid())
+    {
+        FInkSnapshot::Apply(Chunk, *InkSubsystem);
+    }
+}
+
+void APaintManager::OnRep_NetSurfaceIds()
+{
+    int32 NumApplied = 0;
+    while (NumApplied < DeferredNetStamps.Num() && ApplyNetStamp(DeferredNetStamps[NumApplied]))
+    {
+        ++NumApplied;
+    }
+    DeferredNetStamps.RemoveAt(0, NumApplied);
+}
+
+bool APaintManager::ApplyNetStamp(const FInkNetStamp &Stamp)
+{
+    if (!NetSurfaceIds.IsValidIndex(Stamp.SurfaceIndex))
+    {
+        return false;
+    }
+
+    // 表面不存在（例如所在关卡尚未流送）时丢弃，之后由快照补齐
+    UInkSystemComponent *Surface = InkSubsystem.IsValid() ? InkSubsystem->FindSurfaceById(NetSurfaceIds[Stamp.SurfaceIndex]) : nullptr;
+    if (Surface)
+    {
+        PaintTargetByTeam(Surface, Stamp.GetUV(), static_cast<E_Team>(Stamp.Team), Stamp.GetBrushSize());
+    }
+    return true;
+}
+
+float APaintManager::GetNetBytesPerSecond(const APlayerController *Controller) const
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    if (!IsNetServer())
+    {
+        return ReceiveRate.GetBytesPerSecond(Now);
+    }
+
+    for (const FNetClient &Client : NetClients)
+    {
+        if (Client.Controller == Controller)
+        {
+            return Client.Rate.GetBytesPerSecond(Now);
+        }
+    }
+    return 0.0f;
+}
+
+void APaintManager::LogNetStats() const
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    if (!IsNetServer())
+    {
+        UE_LOG(LogTemp, Log, TEXT("PaintManager: Received %.0f B/s (%lld bytes total), %d stamps waiting for surface ids."),
+               ReceiveRate.GetBytesPerSecond(Now), ReceiveRate.TotalBytes, DeferredNetStamps.Num());
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("PaintManager: %d remote clients, %d / %d replicated surfaces."), NetClients.Num(), NetSurfaceIds.Num(), NetMaxSurfaceIds);
+    for (const FNetClient &Client : NetClients)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %s: %.0f B/s (%lld bytes total), %d near / %d far pending%s"),
+               *GetNameSafe(Client.Controller.Get()),
+               Client.Rate.GetBytesPerSecond(Now),
+               Client.Rate.TotalBytes,
+               Client.NearStamps.Num(),
+               Client.FarStamps.Num(),
+               Client.SnapshotWriter ? TEXT(", streaming snapshot") : TEXT(""));
+    }
+}
+
+static FAutoConsoleCommandWithWorld GInkNetStatsCommand(
+    TEXT("ink.Net.Stats"),
+    TEXT("Logs ink replication traffic per client (server) or received traffic (client)."),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld *World)
+    {
+        const UInkWorldSubsystem *Subsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(World);
+        if (const APaintManager *Manager = Subsystem ? Subsystem->GetPaintManager() : nullptr)
+        {
+            Manager->LogNetStats();
+        }
+    }));
+
+UMaterialInstanceDynamic *APaintManager::GetTeamBrushMaterial(E_Team Team) const
+{
+    const int32 TeamIndex = static_cast<int32>(Team) - 1;
+    return TeamBrushMatInsts.IsValidIndex(TeamIndex) ? TeamBrushMatInsts[TeamIndex].Get() : nullptr;
 }
 
 void APaintManager::PaintTargetByTeam(UInkSystemComponent *TargetComp, FVector2D HitUV, E_Team Team, float BrushSize)
@@ -135,3 +645,14 @@ float APaintManager::TeamToFloat(E_Team Team)
         return -1.0f; // 无效
     }
 }
+
+E_Team APaintManager::FloatToTeam(float TeamID)
+{
+    // TeamToFloat 的逆映射
+    if (TeamID < 0.0f)
+    {
+        return E_Team::None;
+    }
+
+    return TeamID < 0.5f ? E_Team::Team1 : E_Team::Team2;
+}
@@ -4,17 +4,68 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "UObject/ObjectKey.h"
 #include "ShooterGameMode.h"
+#include "InkCoverageGrid.h"
+#include "InkNetStamp.h"
+#include "InkSnapshot.h"
 #include "PaintManager.generated.h"
 
+class APlayerController;
+class AShooterPlayerController;
+struct FInkJournalEntry;
 class UInkSystemComponent;
+class UInkWorldSubsystem;
 class UMaterialInstanceDynamic;
 class UMaterialInterface;
+class UTextureRenderTarget2D;
+
+/**
+ * 画刷批处理计数器
+ */
+USTRUCT(BlueprintType)
+struct FInkStampCounters
+{
+    GENERATED_BODY()
+
+    /** PaintTarget 处理的画刷数（包括不绘制 GPU 的专用服务器） */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Stats")
+    int32 StampsPainted = 0;
+
+    /** 被涂色的不同表面数 */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Stats")
+    int32 SurfacesPainted = 0;
+
+    /** 进入队列的画刷数 */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Stats")
+    int32 StampsQueued = 0;
+
+    /** 因同帧落在同一像素而被合并的画刷数 */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Stats")
+    int32 StampsMerged = 0;
+
+    /** 实际绘制到 RenderTarget 的画刷数 */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Stats")
+    int32 StampsFlushed = 0;
+
+    /** Canvas 绘制批次数（每个脏 RenderTarget 一次） */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Stats")
+    int32 CanvasPasses = 0;
+};
 
 /**
  * 涂色管理器
  * 负责将画刷绘制到可涂色表面的 RenderTarget 上
- * 在关卡中放置一个实例，或通过 GameMode 持有
+ * 在关卡中放置一个实例，BeginPlay 时注册到 UInkWorldSubsystem，由子系统派发涂色
+ *
+ * 画刷不会立即绘制，而是按 RenderTarget 保持调用顺序排队，
+ * 在帧末（TG_PostUpdateWork）统一刷新，每个脏 RenderTarget 只做一次 Canvas 绘制，队伍变化处切换画刷材质
+ * CPU 归属网格仍在 PaintTarget 时立即按调用顺序更新，两者的覆盖顺序一致
+ *
+ * 联机时服务器把每帧的画刷打包为 FInkNetStamp 数组，
+ * 经 AShooterPlayerController 的可靠 RPC 按连接发送，客户端收到后在本地重放
+ * 射击目前没有发往服务器的路径：客户端自己的射击只在本地涂色，不会同步给服务器和其他客户端
+ * 远离该玩家视点的表面合并到 NetFarSendInterval 再发送；新加入的客户端先分块接收完整快照
  */
 UCLASS(abstract)
 class PROJECT2_API APaintManager : public AActor
@@ -26,22 +77,59 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const override;
+
+public:
+    /** 帧末刷新本帧排队的画刷 */
+    virtual void Tick(float DeltaSeconds) override;
+
     // ========== 属性 ==========
 
     /** 画刷材质的源材质（在编辑器中指定 M_Brush_Stamp） */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Brush")
     TObjectPtr<UMaterialInterface> BrushSourceMaterial;
 
-    /** 画刷材质的动态实例 */
+    /** 画刷材质的动态实例（Team1，同时作为默认实例） */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Brush")
     TObjectPtr<UMaterialInstanceDynamic> BrushMatInst;
 
+    /** 每个队伍一份画刷材质实例，TeamID 参数在创建时固定，保证同一 Canvas 批次内各队伍颜色正确 */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Paint|Brush")
+    TArray<TObjectPtr<UMaterialInstanceDynamic>> TeamBrushMatInsts;
+
     /** 默认画刷大小（像素） */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Brush", meta = (ClampMin = 8, ClampMax = 256))
     float DefaultBrushSize = 64.0f;
 
+    /** 该距离（cm）内的表面每帧发送画刷，更远的表面按 NetFarSendInterval 合并发送 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Network", meta = (ClampMin = 0, Units = "cm"))
+    float NetNearDistance = 6000.0f;
+
+    /** 远处表面的发送间隔（秒） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Network", meta = (ClampMin = 0, Units = "s"))
+    float NetFarSendInterval = 0.5f;
+
+    /** 每次 RPC 最多携带的画刷数，超出的部分留到下一帧 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Network", meta = (ClampMin = 1))
+    int32 NetMaxStampsPerRPC = 512;
+
+    /** 快照块大小（字节） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Network", meta = (ClampMin = 1024))
+    int32 NetSnapshotChunkBytes = 16384;
+
+    /** 每个连接的快照发送预算（字节 / 秒），上一块按预算摊完之前不发送下一块 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint|Network", meta = (ClampMin = 1024))
+    int32 NetSnapshotBytesPerSecond = 65536;
+
+    /**
+     * NetSurfaceIds 的上限，不超过 net.MaxRepArraySize 的默认值
+     * 超出后新涂色的表面不再分配下标，改为按 NetFarSendInterval 以快照块发送整张归属网格
+     */
+    static constexpr int32 NetMaxSurfaceIds = 2048;
+
     // ========== 涂色方法 ==========
 
     /**
@@ -64,6 +152,33 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Paint")
     void PaintTargetByTeam(UInkSystemComponent *TargetComp, FVector2D HitUV, E_Team Team, float BrushSize = 0.0f);
 
+    /** 立即刷新所有排队的画刷（通常由 Tick 在帧末调用） */
+    UFUNCTION(BlueprintCallable, Category = "Paint")
+    void FlushPendingStamps();
+
+    /** 上一帧的计数 */
+    UFUNCTION(BlueprintPure, Category = "Paint|Stats")
+    FInkStampCounters GetLastFlushCounters() const { return LastFlushCounters; }
+
+    /** 自开始游戏以来的累计计数 */
+    UFUNCTION(BlueprintPure, Category = "Paint|Stats")
+    FInkStampCounters GetTotalCounters() const { return TotalCounters; }
+
+    // ========== 网络同步 ==========
+
+    /** 客户端：应用服务器发来的一批画刷（由 AShooterPlayerController::ClientReceiveInkStamps 调用） */
+    void ReceiveNetStamps(const TArray<uint8> &PackedStamps);
+
+    /** 客户端：应用服务器发来的一个快照块（由 AShooterPlayerController::ClientReceiveInkSnapshot 调用） */
+    void ReceiveNetSnapshot(const TArray<uint8> &Chunk);
+
+    /** 服务器：最近一秒发往该玩家的字节数；客户端：传入本地玩家时返回最近一秒收到的字节数 */
+    UFUNCTION(BlueprintPure, Category = "Paint|Stats")
+    float GetNetBytesPerSecond(const APlayerController *Controller) const;
+
+    /** 输出各连接的同步流量 */
+    void LogNetStats() const;
+
     // ========== 辅助方法 ==========
 
     /**
@@ -74,7 +189,131 @@ public:
     UFUNCTION(BlueprintPure, Category = "Paint")
     static float TeamToFloat(E_Team Team);
 
+    /**
+     * 将材质使用的 TeamID 浮点值转换回 E_Team
+     * @param TeamID	0.0 (Team1), 1.0 (Team2), 负数 (None/无效)
+     * @return			对应的队伍枚举
+     */
+    UFUNCTION(BlueprintPure, Category = "Paint")
+    static E_Team FloatToTeam(float TeamID);
+
 protected:
+    /** 排队中的单个画刷（RenderTarget 像素坐标） */
+    struct FPendingStamp
+    {
+        FVector2D Center;
+        float Size;
+
+        /** 目标表面的像素区域，绘制时裁剪，避免溢出到图集中相邻的表面 */
+        FIntRect ClipRect;
+
+        /** 队伍下标（E_Team - 1） */
+        int32 TeamIndex;
+    };
+
+    /** 某个 RenderTarget 本帧的待绘制画刷，保持调用顺序 */
+    struct FPendingStampBatch
+    {
+        TWeakObjectPtr<UTextureRenderTarget2D> RenderTarget;
+        TArray<FPendingStamp> Stamps;
+
+        /** 合并键（队伍 + 中心像素）-> Stamps 中的下标 */
+        TMap<uint64, int32> StampIndexByKey;
+
+        /** 当前同队伍连续画刷的起始下标；只在这一段内合并，不改变与其他队伍画刷的先后关系 */
+        int32 RunStart = 0;
+    };
+
+    /** 服务器上每个远程连接的发送状态 */
+    struct FNetClient
+    {
+        TWeakObjectPtr<AShooterPlayerController> Controller;
+
+        /** 本帧的玩家视点，用于区分近处和远处的表面 */
+        FVector ViewLocation = FVector::ZeroVector;
+
+        /** 近处表面的待发送画刷，每帧发送 */
+        TArray<FInkNetStamp> NearStamps;
+
+        /** 远处表面的待发送画刷，按 NetFarSendInterval 发送 */
+        TArray<FInkNetStamp> FarStamps;
+
+        /** FarStamps 中涉及的表面；这些表面的后续画刷也进入 FarStamps，保证同一表面的画刷按顺序到达 */
+        TSet<uint16> FarSurfaces;
+
+        double NextFarSendTime = 0.0;
+
+        /** 加入时的完整快照或溢出表面的快照，发送完毕后释放 */
+        TUniquePtr<FInkSnapshotWriter> SnapshotWriter;
+
+        /** 按 NetSnapshotBytesPerSecond 摊销，早于该时间不发送下一块快照 */
+        double NextSnapshotSendTime = 0.0;
+
+        /** 没有表面下标、等待以快照发送的表面 */
+        TSet<TWeakObjectPtr<UInkSystemComponent>> OverflowSurfaces;
+
+        /** 流量统计 */
+        FInkNetRateCounter Rate;
+    };
+
+    /** 服务器：远程连接的发送状态 */
+    TArray<FNetClient> NetClients;
+
+    /** 服务器：表面 ID -> NetSurfaceIds 下标 */
+    TMap<uint32, uint16> NetIndexBySurfaceId;
+
+    /** 表面 ID 表，画刷中以下标引用表面；只增不减，新客户端随初始复制收到完整表 */
+    UPROPERTY(ReplicatedUsing = OnRep_NetSurfaceIds)
+    TArray<uint32> NetSurfaceIds;
+
+    /** 客户端：表面下标尚未复制到的画刷，等 OnRep_NetSurfaceIds 后应用 */
+    TArray<FInkNetStamp> DeferredNetStamps;
+
+    /** 客户端：接收流量统计 */
+    FInkNetRateCounter ReceiveRate;
+
+    UFUNCTION()
+    void OnRep_NetSurfaceIds();
+
+    /** 是否需要向远程连接同步画刷 */
+    bool IsNetServer() const;
+
+    /** 服务器：把一次涂色加入各连接的发送队列 */
+    void QueueNetStamp(UInkSystemComponent *TargetComp, const FInkJournalEntry &Entry);
+
+    /** 服务器：在预算允许时发送一个快照块，空块不发送 */
+    void SendNetSnapshotChunk(FNetClient &Client, double Now);
+
+    /** 服务器：同步连接列表，并发送快照块和到期的画刷 */
+    void SendNetStamps();
+
+    /** 服务器：通过 RPC 发送近处队列的前 NetMaxStampsPerRPC 项 */
+    void SendNetStampBatch(FNetClient &Client, double Now);
+
+    /** 客户端：应用一个画刷，下标未知时返回 false */
+    bool ApplyNetStamp(const FInkNetStamp &Stamp);
+
+    /** 以 RenderTarget 为键的待刷新批次 */
+    TMap<TObjectKey<UTextureRenderTarget2D>, FPendingStampBatch> PendingBatches;
+
+    /** 注册到的墨水子系统 */
+    TWeakObjectPtr<UInkWorldSubsystem> InkSubsystem;
+
+    /** 本帧累计的计数 */
+    FInkStampCounters PendingCounters;
+
+    /** 上一次刷新的计数 */
+    FInkStampCounters LastFlushCounters;
+
+    /** 累计计数 */
+    FInkStampCounters TotalCounters;
+
     /** 初始化画刷材质实例 */
     void InitializeBrushMaterial();
+
+    /** 将画刷加入对应 RenderTarget 的批次，同帧同像素同队伍的画刷会被合并 */
+    void QueueStamp(UTextureRenderTarget2D *RenderTarget, const FIntRect &ClipRect, const FVector2D &PixelCenter, float BrushSize, E_Team Team);
+
+    /** 获取指定队伍的画刷材质实例 */
+    UMaterialInstanceDynamic *GetTeamBrushMaterial(E_Team Team) const;
 };
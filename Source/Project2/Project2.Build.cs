@@ -18,6 +18,7 @@ public class Project2 : ModuleRules
 			"Slate",
 			"PhysicsCore",
             "RenderCore",
+			"TraceLog",
         });
 
 		PrivateDependencyModuleNames.AddRange(new string[] { });
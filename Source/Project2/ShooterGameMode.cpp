@@ -1,9 +1,40 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGameMode.h"
+#include "ShooterGameState.h"
 #include "UI/ShooterUI.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
+#include "Ink/InkWorldSubsystem.h"
+
+AShooterGameMode::AShooterGameMode()
+{
+	GameStateClass = AShooterGameState::StaticClass();
+}
+
+void AShooterGameMode::InitGame(const FString &MapName, const FString &Options, FString &ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// URL 选项优先，其次是固定种子，都没有时每局随机
+	MatchSeed = UGameplayStatics::GetIntOption(Options, TEXT("MatchSeed"), FixedMatchSeed);
+	if (MatchSeed == 0)
+	{
+		MatchSeed = static_cast<int32>(FPlatformTime::Cycles() ^ static_cast<uint32>(FMath::Rand()));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ShooterGameMode: MatchSeed=%d"), MatchSeed);
+}
+
+void AShooterGameMode::InitGameState()
+{
+	Super::InitGameState();
+
+	if (AShooterGameState *ShooterGameState = GetGameState<AShooterGameState>())
+	{
+		ShooterGameState->SetMatchSeed(MatchSeed);
+	}
+}
 
 void AShooterGameMode::BeginPlay()
 {
@@ -32,3 +63,14 @@ void AShooterGameMode::IncrementTeamScore(E_Team Team)
 	// 通知 UI 更新
 	ShooterUI->BP_UpdateScore(TeamByte, Score);
 }
+
+float AShooterGameMode::GetTeamTerritoryPercent(E_Team Team) const
+{
+	// 领地像素数在涂色时增量维护，这里只做一次除法
+	if (const UInkWorldSubsystem *InkSubsystem = GetWorld()->GetSubsystem<UInkWorldSubsystem>())
+	{
+		return InkSubsystem->GetTeamTerritoryRatio(Team) * 100.0f;
+	}
+
+	return 0.0f;
+}
@@ -19,6 +19,7 @@ enum class E_Team : uint8
 /**
  *  简单第一人称射击游戏的 GameMode
  *  管理游戏 UI 和阵营比分
+ *  领地比例由 UInkWorldSubsystem 在涂色时增量统计，可随时常数时间读取
  */
 UCLASS(abstract)
 class PROJECT2_API AShooterGameMode : public AGameModeBase
@@ -36,11 +37,35 @@ protected:
 	/** 按队伍 ID 记录的积分表 */
 	TMap<uint8, int32> TeamScores;
 
+	/** 固定的对局随机种子（非 0 时使用，便于复现和自动化测试）；也可用 URL 选项 ?MatchSeed=N 指定 */
+	UPROPERTY(EditAnywhere, Category = "Shooter|Random")
+	int32 FixedMatchSeed = 0;
+
+	/** 本局的随机种子，武器散布等确定性随机数由它派生；通过 AShooterGameState 同步给客户端 */
+	int32 MatchSeed = 0;
+
+public:
+	/** 构造函数 */
+	AShooterGameMode();
+
 protected:
+	/** 对局初始化，生成对局随机种子 */
+	virtual void InitGame(const FString &MapName, const FString &Options, FString &ErrorMessage) override;
+
+	/** 把对局随机种子写入 GameState 以同步给客户端 */
+	virtual void InitGameState() override;
+
 	/** 游戏开始时的初始化 */
 	virtual void BeginPlay() override;
 
 public:
 	/** 为指定队伍增加积分并更新 UI */
 	void IncrementTeamScore(E_Team Team);
+
+	/** 本局的随机种子 */
+	int32 GetMatchSeed() const { return MatchSeed; }
+
+	/** 获取指定队伍当前的全局领地百分比（0-100） */
+	UFUNCTION(BlueprintPure, Category = "Shooter|Territory")
+	float GetTeamTerritoryPercent(E_Team Team) const;
 };
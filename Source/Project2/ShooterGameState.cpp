@@ -0,0 +1,12 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGameState.h"
+#include "Net/UnrealNetwork.h"
+
+void AShooterGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// 种子在对局开始时确定，之后不再变化
+	DOREPLIFETIME_CONDITION(AShooterGameState, MatchSeed, COND_InitialOnly);
+}
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "ShooterGameState.generated.h"
+
+/**
+ *  简单第一人称射击游戏的 GameState
+ *  把服务器生成的对局随机种子同步给所有客户端，两端由它派生相同的确定性随机数（如武器散布）
+ */
+UCLASS()
+class PROJECT2_API AShooterGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+protected:
+	/** 本局的随机种子，由 AShooterGameMode 在创建 GameState 时写入 */
+	UPROPERTY(Replicated)
+	int32 MatchSeed = 0;
+
+public:
+	/** 同步属性注册 */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty> &OutLifetimeProps) const override;
+
+	/** 设置本局的随机种子（仅服务器） */
+	void SetMatchSeed(int32 InMatchSeed) { MatchSeed = InMatchSeed; }
+
+	/** 本局的随机种子（客户端在同步到达前为 0） */
+	int32 GetMatchSeed() const { return MatchSeed; }
+};
@@ -8,6 +8,8 @@
 #include "GameFramework/PlayerStart.h"
 #include "Character/ShooterCharacter.h"
 #include "UI/ShooterBulletCounterUI.h"
+#include "Ink/InkWorldSubsystem.h"
+#include "Ink/PaintManager.h"
 #include "Project2.h"
 #include "Widgets/Input/SVirtualJoystick.h"
 
@@ -119,3 +121,20 @@ void AShooterPlayerController::OnPawnDamaged(float LifePercent)
 	}
 }
 
+void AShooterPlayerController::ClientReceiveInkStamps_Implementation(const TArray<uint8> &PackedStamps)
+{
+	const UInkWorldSubsystem *InkSubsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(GetWorld());
+	if (APaintManager *PaintManager = InkSubsystem ? InkSubsystem->GetPaintManager() : nullptr)
+	{
+		PaintManager->ReceiveNetStamps(PackedStamps);
+	}
+}
+
+void AShooterPlayerController::ClientReceiveInkSnapshot_Implementation(const TArray<uint8> &Chunk)
+{
+	const UInkWorldSubsystem *InkSubsystem = UWorld::GetSubsystem<UInkWorldSubsystem>(GetWorld());
+	if (APaintManager *PaintManager = InkSubsystem ? InkSubsystem->GetPaintManager() : nullptr)
+	{
+		PaintManager->ReceiveNetSnapshot(Chunk);
+	}
+}
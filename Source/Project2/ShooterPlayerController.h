@@ -62,5 +62,13 @@ protected:
 	UFUNCTION()
 	void OnPawnDamaged(float LifePercent);
 
+public:
+	/** 接收服务器打包的墨水画刷（FInkNetStamp 数组），交给 APaintManager 在本地重放 */
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveInkStamps(const TArray<uint8> &PackedStamps);
+
+	/** 接收加入时的墨水快照数据块 */
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveInkSnapshot(const TArray<uint8> &Chunk);
 
 };
@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InkProjectileMovementComponent.h"
+
+namespace InkProjectileMovement
+{
+	/** k dt 小于该值时用泰勒展开代替 (1 - e^(-k dt)) / k，避免相减抵消 */
+	constexpr double SmallDecay = 1e-4;
+}
+
+FVector UInkProjectileMovementComponent::ComputeVelocity(FVector InitialVelocity, float DeltaTime) const
+{
+	// 重力与追踪等加速度仍由基类计算，水平分量在此基础上按精确因子衰减
+	const FVector Acceleration = ComputeAcceleration(InitialVelocity, DeltaTime);
+	const double Decay = FMath::Exp(-static_cast<double>(HorizontalDeceleration) * DeltaTime);
+
+	FVector NewVelocity(
+		InitialVelocity.X * Decay + Acceleration.X * DeltaTime,
+		InitialVelocity.Y * Decay + Acceleration.Y * DeltaTime,
+		InitialVelocity.Z + Acceleration.Z * DeltaTime);
+
+	return LimitVelocity(NewVelocity);
+}
+
+FVector UInkProjectileMovementComponent::ComputeMoveDelta(const FVector &InVelocity, float DeltaTime) const
+{
+	const double KT = static_cast<double>(HorizontalDeceleration) * DeltaTime;
+	if (KT <= 0.0)
+	{
+		return Super::ComputeMoveDelta(InVelocity, DeltaTime);
+	}
+
+	// 水平位移为衰减速度在子步内的积分，竖直方向与基类相同（匀加速）
+	const double Horizontal = KT < InkProjectileMovement::SmallDecay
+								  ? DeltaTime * (1.0 - KT * (0.5 - KT / 6.0))
+								  : (1.0 - FMath::Exp(-KT)) / HorizontalDeceleration;
+
+	const FVector Acceleration = ComputeAcceleration(InVelocity, DeltaTime);
+	return FVector(
+		InVelocity.X * Horizontal + 0.5 * Acceleration.X * DeltaTime * DeltaTime,
+		InVelocity.Y * Horizontal + 0.5 * Acceleration.Y * DeltaTime * DeltaTime,
+		InVelocity.Z * DeltaTime + 0.5 * Acceleration.Z * DeltaTime * DeltaTime);
+}
@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "InkProjectileMovementComponent.generated.h"
+
+/**
+ *  带水平指数衰减的投射物移动组件
+ *  在每个子步的 ComputeMoveDelta / ComputeVelocity 中按解析式应用衰减：
+ *    位移 d_h = v_h * (1 - e^(-k dt)) / k，速度 v_h' = v_h * e^(-k dt)，竖直方向为恒定重力
+ *  子步的组合与 FShooterProjectileTrajectory 完全一致，因此飞行路径与帧率和子步划分无关，
+ *  投射物 Actor 不再需要自己 Tick
+ */
+UCLASS(ClassGroup = Movement, meta = (BlueprintSpawnableComponent))
+class PROJECT2_API UInkProjectileMovementComponent : public UProjectileMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** 水平衰减率（每秒），越大衰减越快 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = 0))
+	float HorizontalDeceleration = 0.0f;
+
+	virtual FVector ComputeVelocity(FVector InitialVelocity, float DeltaTime) const override;
+	virtual FVector ComputeMoveDelta(const FVector &InVelocity, float DeltaTime) const override;
+};
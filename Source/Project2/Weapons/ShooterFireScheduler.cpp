@@ -0,0 +1,138 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterFireScheduler.h"
+#include "ShooterWeapon.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Ink/InkStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Fire Scheduler"), STAT_ShooterFireScheduler, STATGROUP_Ink);
+
+namespace ShooterFireScheduler
+{
+	/** 射击间隔下限（秒），与 AShooterWeapon::RefireRate 的 ClampMin 一致 */
+	constexpr double MinRefireInterval = 0.01;
+}
+
+bool UShooterFireScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// 只在实际游戏世界中运行
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterFireScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterFireScheduler, STATGROUP_Tickables);
+}
+
+void UShooterFireScheduler::StartFiring(AShooterWeapon *Weapon, double NextShotTime)
+{
+	for (FEntry &Entry : Entries)
+	{
+		if (Entry.Weapon == Weapon)
+		{
+			Entry.NextShotTime = NextShotTime;
+			return;
+		}
+	}
+
+	FEntry &Entry = Entries.AddDefaulted_GetRef();
+	Entry.Weapon = Weapon;
+	Entry.NextShotTime = NextShotTime;
+}
+
+void UShooterFireScheduler::StopFiring(AShooterWeapon *Weapon)
+{
+	// 射击回调中可能停止任意武器，这里只清空，Tick 结束时移除
+	for (FEntry &Entry : Entries)
+	{
+		if (Entry.Weapon == Weapon)
+		{
+			Entry.Weapon.Reset();
+		}
+	}
+}
+
+void UShooterFireScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterFireScheduler);
+
+	if (Entries.IsEmpty())
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	ShotsThisFrame = 0;
+
+	// 射击回调可能增删条目，每次都按下标重新取
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		// 积压超过 MaxCatchUpTime 的射击不再补发，落后量有上限
+		Entries[Index].NextShotTime = FMath::Max(Entries[Index].NextShotTime, Now - MaxCatchUpTime);
+
+		int32 Shots = 0;
+		while (AShooterWeapon *Weapon = Entries[Index].Weapon.Get())
+		{
+			const double ShotTime = Entries[Index].NextShotTime;
+			if (ShotTime > Now)
+			{
+				break;
+			}
+
+			// 超出每帧上限的射击留到下一帧，保留理论开火时刻（受 MaxCatchUpTime 限制）
+			if (Shots >= MaxShotsPerFrame)
+			{
+				break;
+			}
+
+			++Shots;
+			Entries[Index].NextShotTime = ShotTime + FMath::Max(static_cast<double>(Weapon->GetRefireRate()), ShooterFireScheduler::MinRefireInterval);
+
+			// 松开扳机或弹匣打空时武器返回 false
+			if (!Weapon->FireShot(static_cast<float>(Now - ShotTime)))
+			{
+				Entries[Index].Weapon.Reset();
+			}
+		}
+
+		ShotsThisFrame += Shots;
+	}
+
+	Entries.RemoveAllSwap([](const FEntry &Entry) { return !Entry.Weapon.IsValid(); }, EAllowShrinking::No);
+}
+
+int32 UShooterFireScheduler::GetNumFiring() const
+{
+	int32 Num = 0;
+	for (const FEntry &Entry : Entries)
+	{
+		Num += Entry.Weapon.IsValid() ? 1 : 0;
+	}
+	return Num;
+}
+
+void UShooterFireScheduler::LogStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("ShooterFireScheduler: Firing=%d ShotsLastFrame=%d"), GetNumFiring(), ShotsThisFrame);
+	for (const FEntry &Entry : Entries)
+	{
+		if (const AShooterWeapon *Weapon = Entry.Weapon.Get())
+		{
+			UE_LOG(LogTemp, Log, TEXT("  %s RefireRate=%.4fs NextShot=%.4f"), *GetNameSafe(Weapon), Weapon->GetRefireRate(), Entry.NextShotTime);
+		}
+	}
+}
+
+// ========== 控制台命令 ==========
+
+static FAutoConsoleCommandWithWorld GShooterFireSchedulerStatsCommand(
+	TEXT("shooter.FireScheduler.Stats"),
+	TEXT("Logs weapons currently driven by the fire scheduler."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld *World)
+	{
+		if (const UShooterFireScheduler *Scheduler = UWorld::GetSubsystem<UShooterFireScheduler>(World))
+		{
+			Scheduler->LogStats();
+		}
+	}));
@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterFireScheduler.generated.h"
+
+class AShooterWeapon;
+
+/**
+ *  全自动武器的统一射击调度
+ *  每把按住扳机的武器只记录下一发的理论开火时刻，子系统每帧把到期的射击全部发出：
+ *  - 射速高于帧率时一帧发出多发，每发带有自己的帧内时刻，投射物按 (当前时间 - 开火时刻) 沿轨迹补齐飞行
+ *  - 下一发时刻在上一发的理论时刻上累加 RefireRate，不受帧边界量化影响，任何帧率下射速一致
+ *  - 不再为每发射击重新设置计时器
+ */
+UCLASS(config = Game)
+class PROJECT2_API UShooterFireScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 单把武器每帧最多发出的射击数，超出的部分顺延到之后的帧（卡顿后分摊补射） */
+	UPROPERTY(Config)
+	int32 MaxShotsPerFrame = 8;
+
+	/**
+	 * 顺延射击最多落后当前时间的秒数，更早的积压直接丢弃
+	 * 射速超过 MaxShotsPerFrame * 帧率时积压不会无限增长，扳机松开后也不会继续补射
+	 */
+	UPROPERTY(Config)
+	float MaxCatchUpTime = 0.1f;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * 开始（或更新）一把武器的连续射击
+	 * @param Weapon		武器
+	 * @param NextShotTime	下一发的世界时间
+	 */
+	void StartFiring(AShooterWeapon *Weapon, double NextShotTime);
+
+	/** 停止一把武器的连续射击 */
+	void StopFiring(AShooterWeapon *Weapon);
+
+	/** 正在连续射击的武器数 */
+	int32 GetNumFiring() const;
+
+	/** 输出正在连续射击的武器 */
+	void LogStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AShooterWeapon> Weapon;
+
+		/** 下一发的理论开火时刻（世界时间） */
+		double NextShotTime = 0.0;
+	};
+
+	/** 已停止的条目在 Tick 中只清空武器，循环结束后统一移除 */
+	TArray<FEntry> Entries;
+
+	/** 本帧累计发出的射击数 */
+	int32 ShotsThisFrame = 0;
+};
@@ -2,7 +2,7 @@
 
 #include "ShooterProjectile.h"
 #include "Components/SphereComponent.h"
-#include "GameFramework/ProjectileMovementComponent.h"
+#include "InkProjectileMovementComponent.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/DamageType.h"
@@ -10,12 +10,15 @@
 #include "GameFramework/Controller.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
-#include "Ink/InkSystemComponent.h"
-#include "Ink/PaintManager.h"
+#include "Ink/InkWorldSubsystem.h"
+#include "Ink/InkStats.h"
+#include "ShooterProjectilePool.h"
+#include "ShooterProjectileTrajectory.h"
 
 AShooterProjectile::AShooterProjectile()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// 水平衰减由移动组件在每个子步中处理，Actor 不需要 Tick
+	PrimaryActorTick.bCanEverTick = false;
 
 	// 创建碰撞球组件并设为根节点
 	RootComponent = CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("Collision Component"));
@@ -26,7 +29,7 @@ AShooterProjectile::AShooterProjectile()
 	CollisionComponent->CanCharacterStepUpOn = ECanBeCharacterBase::ECB_No;
 
 	// 创建投射物移动组件（非场景组件，无需 Attach）
-	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("Projectile Movement"));
+	ProjectileMovement = CreateDefaultSubobject<UInkProjectileMovementComponent>(TEXT("Projectile Movement"));
 
 	// 注意：不在构造函数中设置速度，应该在 PostInitializeComponents 中设置
 	ProjectileMovement->bShouldBounce = true;
@@ -39,10 +42,32 @@ void AShooterProjectile::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// 记录碰撞设置，从池中取出时恢复
+	InitialCollisionEnabled = CollisionComponent->GetCollisionEnabled();
+	InitialObjectType = CollisionComponent->GetCollisionObjectType();
+	InitialCollisionResponses = CollisionComponent->GetCollisionResponseToChannels();
+
 	// 在 BeginPlay 时应用速度和重力设置
+	// 不限速：限速会在每个子步截断速度，使路径偏离解析轨迹并随帧率变化
 	ProjectileMovement->InitialSpeed = Speed;
-	ProjectileMovement->MaxSpeed = Speed;
+	ProjectileMovement->MaxSpeed = 0.0f;
 	ProjectileMovement->ProjectileGravityScale = GravityScale;
+	ProjectileMovement->HorizontalDeceleration = HorizontalDeceleration;
+
+	// 预热生成的投射物直接进入池中
+	if (bInPool)
+	{
+		EnterPool();
+		return;
+	}
+
+	Launch();
+}
+
+void AShooterProjectile::Launch()
+{
+	++InkStats::LiveProjectiles;
+	INC_DWORD_STAT(STAT_InkLiveProjectiles);
 
 	// 设置投射物沿着 Actor 的 Forward 方向发射
 	ProjectileMovement->Velocity = GetActorForwardVector() * Speed;
@@ -51,38 +76,77 @@ void AShooterProjectile::BeginPlay()
 	CollisionComponent->IgnoreActorWhenMoving(GetInstigator(), true);
 }
 
-void AShooterProjectile::Tick(float DeltaSeconds)
+void AShooterProjectile::ActivateFromPool(const FTransform &Transform, AActor *NewOwner, APawn *NewInstigator)
 {
-	Super::Tick(DeltaSeconds);
+	bInPool = false;
+	bHit = false;
+	bAttachedToTarget = false;
 
-	if (!ProjectileMovement || bHit)
-	{
-		return;
-	}
+	SetOwner(NewOwner);
+	SetInstigator(NewInstigator);
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// 恢复碰撞（可能被命中后的物理配置或 NoCollision 覆盖）
+	CollisionComponent->ClearMoveIgnoreActors();
+	CollisionComponent->SetCollisionObjectType(InitialObjectType);
+	CollisionComponent->SetCollisionResponseToChannels(InitialCollisionResponses);
+	CollisionComponent->SetCollisionEnabled(InitialCollisionEnabled);
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
 
-	// 获取当前速度
-	FVector Vel = ProjectileMovement->Velocity;
+	// 反弹停止时移动组件会清空 UpdatedComponent，需要重新绑定
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->Activate(true);
 
-	// 分离水平速度（忽略 Z）
-	FVector HorizontalVel = FVector(Vel.X, Vel.Y, 0.0f);
-	float HorSpeed = HorizontalVel.Size();
+	SetLifeSpan(InitialLifeSpan);
 
-	if (HorSpeed > KINDA_SMALL_NUMBER)
+	Launch();
+}
+
+void AShooterProjectile::EnterPool()
+{
+	// 预热生成的投射物从未计入存活数量
+	if (!bInPool)
 	{
-		// 指数衰减：newSpeed = speed * exp(-decayRate * dt)
-		float DecayFactor = FMath::Exp(-HorizontalDeceleration * DeltaSeconds);
-		float NewHorSpeed = HorSpeed * DecayFactor;
+		--InkStats::LiveProjectiles;
+		DEC_DWORD_STAT(STAT_InkLiveProjectiles);
+	}
+	bInPool = true;
+
+	GetWorld()->GetTimerManager().ClearTimer(DestructionTimer);
+	SetLifeSpan(0.0f);
 
-		// 重新设置速度向量
-		FVector NewHorizontalVel = (HorizontalVel / HorSpeed) * NewHorSpeed;
-		ProjectileMovement->Velocity = FVector(NewHorizontalVel.X, NewHorizontalVel.Y, Vel.Z);
+	// 解除附着和物理模拟
+	if (bAttachedToTarget)
+	{
+		DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 	}
+	CollisionComponent->SetSimulatePhysics(false);
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	bHit = false;
+	bAttachedToTarget = false;
+	OwningTeam = E_Team::None;
 }
 
 void AShooterProjectile::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	// 池中的投射物已经不计入存活数量
+	if (!bInPool)
+	{
+		--InkStats::LiveProjectiles;
+		DEC_DWORD_STAT(STAT_InkLiveProjectiles);
+	}
+
 	// 清除可能正在等待的销毁定时器
 	GetWorld()->GetTimerManager().ClearTimer(DestructionTimer);
 }
@@ -125,104 +189,146 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent *MyComp, AActor *Ot
 	}
 	else
 	{
-		// 立即销毁
-		Destroy();
+		// 立即结束
+		Retire();
 	}
 }
 
 void AShooterProjectile::ProcessHit(AActor *HitActor, UPrimitiveComponent *HitComp, const FVector &HitLocation, const FVector &HitDirection)
+{
+	ApplyImpactDamage(HitActor, GetOwner(), GetInstigator(), this, HitDamage, HitDamageType, bDamageOwner);
+}
+
+FShooterProjectileTrajectory AShooterProjectile::MakeTrajectory(const UWorld &World, TSubclassOf<AShooterProjectile> ProjectileClass, const FVector &Location, const FVector &Direction)
+{
+	const AShooterProjectile *Defaults = ProjectileClass ? ProjectileClass->GetDefaultObject<AShooterProjectile>() : GetDefault<AShooterProjectile>();
+	return FShooterProjectileTrajectory(Location, Direction * Defaults->Speed, World.GetGravityZ() * Defaults->GravityScale, Defaults->HorizontalDeceleration);
+}
+
+void AShooterProjectile::ApplyImpactDamage(AActor *HitActor, AActor *ProjectileOwner, APawn *Instigator, AActor *DamageCauser, float Damage, TSubclassOf<UDamageType> DamageType, bool bCanDamageOwner)
 {
 	// 是否命中角色？
 	if (ACharacter *HitCharacter = Cast<ACharacter>(HitActor))
 	{
 		// 默认忽略该投射物的拥有者，除非允许自伤
-		if (HitCharacter != GetOwner() || bDamageOwner)
+		if ((HitCharacter != ProjectileOwner || bCanDamageOwner) && Instigator)
 		{
 			// 对角色造成伤害
-			UGameplayStatics::ApplyDamage(HitCharacter, HitDamage, GetInstigator()->GetController(), this, HitDamageType);
+			UGameplayStatics::ApplyDamage(HitCharacter, Damage, Instigator->GetController(), DamageCauser, DamageType);
 		}
 	}
 }
 
 void AShooterProjectile::OnDeferredDestruction()
 {
-	// 延迟销毁投射物
-	Destroy();
+	// 延迟结束投射物
+	Retire();
+}
+
+void AShooterProjectile::ContinueFromSimulatedHit(const FHitResult &Hit, const FVector &HitVelocity)
+{
+	bHit = true;
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// 以命中时的速度进入附着 / 物理行为
+	ProjectileMovement->Velocity = HitVelocity;
+	ProcessHitBehavior(Hit.GetComponent(), Hit);
+
+	if (DeferredDestructionTime > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(DestructionTimer, this, &AShooterProjectile::OnDeferredDestruction, DeferredDestructionTime, false);
+	}
+	else
+	{
+		Retire();
+	}
+}
+
+void AShooterProjectile::AdvanceFlight(float FlightTime)
+{
+	if (FlightTime <= 0.0f || bHit)
+	{
+		return;
+	}
+
+	// 与移动组件相同的重力和水平衰减
+	const FShooterProjectileTrajectory Trajectory(GetActorLocation(), ProjectileMovement->Velocity, GetWorld()->GetGravityZ() * GravityScale, HorizontalDeceleration);
+	SetActorLocation(Trajectory.GetPosition(FlightTime), true);
+
+	// 途中命中时由 NotifyHit 接管速度
+	if (!bHit)
+	{
+		ProjectileMovement->Velocity = Trajectory.GetVelocity(FlightTime);
+	}
+}
+
+void AShooterProjectile::LifeSpanExpired()
+{
+	if (bFromPool)
+	{
+		Retire();
+		return;
+	}
+
+	Super::LifeSpanExpired();
+}
+
+void AShooterProjectile::Retire()
+{
+	UShooterProjectilePool *Pool = bFromPool ? GetWorld()->GetSubsystem<UShooterProjectilePool>() : nullptr;
+	if (Pool)
+	{
+		Pool->Release(this);
+	}
+	else
+	{
+		Destroy();
+	}
 }
 
 /** 处理涂色逻辑 */
 void AShooterProjectile::ProcessPainting(const FHitResult &ImpactHit)
 {
-	// 1. 二次射线检测 (Double Check)
-	// 高速物体的 HitResult 有时可能会丢失 UV 信息，或者 Hit 的位置不够深。
-	// 我们沿着子弹反方向做一次短距离射线，确保 "TraceComplex" 开启。
+	FVector2D UV;
+	const bool bFoundUV = PaintImpact(GetWorld(), ImpactHit, OwningTeam, PaintSplatRadius, UV);
 
-	FVector Start = ImpactHit.Location + (ImpactHit.ImpactNormal * 10.0f); // 从击中点外面一点
-	FVector End = ImpactHit.Location - (ImpactHit.ImpactNormal * 20.0f);   // 射入物体内部
+	// 只对已注册的可涂色表面触发（UV 由墨水子系统求得，不可涂色的表面没有 UV）
+	if (bFoundUV)
+	{
+		// 保留蓝图事件以供自定义扩展（可选）
+		TriggerPaintOnActor(ImpactHit.GetActor(), UV, OwningTeam);
+	}
+}
 
-	FCollisionQueryParams TraceParams(FName(TEXT("PaintTrace")), true, this);
-	TraceParams.bReturnFaceIndex = true; // 必须开启！为了获取 FaceIndex
-	TraceParams.bTraceComplex = true;	 // 必须开启！为了通过 Mesh 计算 UV
+bool AShooterProjectile::PaintImpact(UWorld *World, const FHitResult &ImpactHit, E_Team Team, float SplatRadius, FVector2D &OutUV)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InkTrace);
 
-	FHitResult UVHitResult;
-	bool bTraceHit = GetWorld()->LineTraceSingleByChannel(
-		UVHitResult,
-		Start,
-		End,
-		ECC_Visibility, // 确保你的地板阻挡这个 Channel
-		TraceParams);
+	UInkWorldSubsystem *InkSubsystem = World ? World->GetSubsystem<UInkWorldSubsystem>() : nullptr;
+	if (!InkSubsystem || !ImpactHit.Component.IsValid())
+	{
+		return false;
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("ProcessPainting: bTraceHit=%d, HitActor=%s"),
-		   bTraceHit, *GetNameSafe(UVHitResult.GetActor()));
+	// 命中点 -> UV1 由网格共享的三角形 BVH 直接计算，不需要二次复杂射线检测和 "Support UV From Hit Results"
+	// 只有已注册的可涂色表面能求得 UV
+	const bool bFoundUV = InkSubsystem->ComputeSurfaceUV(ImpactHit.GetComponent(), ImpactHit.ImpactPoint, ImpactHit.ImpactNormal, OutUV);
 
-	if (bTraceHit && UVHitResult.Component.IsValid())
+	bool bPainted = false;
+	if (SplatRadius > 0.0f)
+	{
+		// 球形溅射覆盖接缝两侧的所有表面，UV 仍取被命中表面上的点供蓝图事件使用
+		bPainted = InkSubsystem->PaintSphere(ImpactHit.ImpactPoint, SplatRadius, Team) > 0;
+	}
+	else if (bFoundUV)
 	{
-		FVector2D UV;
-		// 2. 获取 UV (对应蓝图的 FindCollisionUV)
-		// 关键点：Channel 设为 1 (Lightmap UV)
-		bool bFoundUV = UGameplayStatics::FindCollisionUV(UVHitResult, 1, UV);
+		bPainted = InkSubsystem->PaintSurface(ImpactHit.GetComponent(), OutUV, Team, 0.0f);
+	}
 
-		UE_LOG(LogTemp, Log, TEXT("ProcessPainting: bFoundUV=%d, UV=(%f, %f)"),
-			   bFoundUV, UV.X, UV.Y);
+	UE_LOG(LogTemp, Verbose, TEXT("ProcessPainting: bFoundUV=%d, bPainted=%d, HitActor=%s, UV=(%f, %f), OwningTeam=%d"),
+		   bFoundUV, bPainted, *GetNameSafe(ImpactHit.GetActor()), OutUV.X, OutUV.Y, (int32)Team);
 
-		if (bFoundUV)
-		{
-			// 查找目标 Actor 上的 InkSystemComponent
-			AActor *HitActor = UVHitResult.GetActor();
-			UInkSystemComponent *InkComp = HitActor->FindComponentByClass<UInkSystemComponent>();
-
-			UE_LOG(LogTemp, Log, TEXT("ProcessPainting: InkComp=%s"),
-				   InkComp ? TEXT("Found") : TEXT("NULL"));
-
-			if (InkComp)
-			{
-				// 获取场景中的 PaintManager
-				APaintManager *PaintMgr = Cast<APaintManager>(
-					UGameplayStatics::GetActorOfClass(GetWorld(), APaintManager::StaticClass()));
-
-				UE_LOG(LogTemp, Log, TEXT("ProcessPainting: PaintMgr=%s, OwningTeam=%d"),
-					   PaintMgr ? TEXT("Found") : TEXT("NULL"), (int32)OwningTeam);
-
-				if (PaintMgr)
-				{
-					// 使用 C++ 涂色系统
-					PaintMgr->PaintTargetByTeam(InkComp, UV, OwningTeam);
-				}
-				else
-				{
-					UE_LOG(LogTemp, Error, TEXT("ProcessPainting: PaintManager not found in level!"));
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Warning, TEXT("ProcessPainting: Hit actor '%s' has no InkSystemComponent!"),
-					   *GetNameSafe(HitActor));
-			}
-
-			// 保留蓝图事件以供自定义扩展（可选）
-			TriggerPaintOnActor(HitActor, UV, OwningTeam);
-		}
-	}
+	return bFoundUV;
 }
 
 /** 根据被击中组件的 Mobility 处理碰撞后的行为 */
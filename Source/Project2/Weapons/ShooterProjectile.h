@@ -8,9 +8,13 @@
 #include "ShooterProjectile.generated.h"
 
 class USphereComponent;
-class UProjectileMovementComponent;
+class UInkProjectileMovementComponent;
 class ACharacter;
 class UPrimitiveComponent;
+class UShooterProjectilePool;
+class UShooterProjectileSimulation;
+class UStaticMesh;
+struct FShooterProjectileTrajectory;
 
 /**
  *  简单第一人称射击投射物类
@@ -26,7 +30,7 @@ class PROJECT2_API AShooterProjectile : public AActor
 
 	/** 控制投射物移动的组件 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
-	UProjectileMovementComponent *ProjectileMovement;
+	UInkProjectileMovementComponent *ProjectileMovement;
 
 protected:
 	/**重力系数*/
@@ -53,6 +57,18 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Projectile|Hit")
 	bool bDamageOwner = false;
 
+	/** 墨水溅射半径，大于 0 时以命中点为球心涂色所有相交的表面（跨墙角和相邻网格），为 0 时只涂被命中的表面 */
+	UPROPERTY(EditAnywhere, Category = "Projectile|Paint", meta = (ClampMin = 0, Units = "cm"))
+	float PaintSplatRadius = 0.0f;
+
+	/** 无 Actor 模拟（UShooterProjectileSimulation）中用于实例化渲染的网格，未设置时该类不参与无 Actor 模拟 */
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile|Simulation")
+	TObjectPtr<UStaticMesh> SimulationMesh;
+
+	/** 实例化渲染时的网格缩放 */
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile|Simulation")
+	FVector SimulationMeshScale = FVector::OneVector;
+
 	/** 是否已命中某个表面 */
 	bool bHit = false;
 
@@ -63,6 +79,21 @@ protected:
 	/** 延迟销毁计时器 */
 	FTimerHandle DestructionTimer;
 
+private:
+	friend class UShooterProjectilePool;
+	friend class UShooterProjectileSimulation;
+
+	/** 是否由投射物池生成（结束时归还而不是销毁） */
+	bool bFromPool = false;
+
+	/** 是否正停留在池中（隐藏、无碰撞、不移动） */
+	bool bInPool = false;
+
+	/** BeginPlay 时记录的碰撞设置，从池中取出时恢复（命中可移动物体后会被改为物理配置） */
+	TEnumAsByte<ECollisionEnabled::Type> InitialCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+	TEnumAsByte<ECollisionChannel> InitialObjectType = ECC_WorldDynamic;
+	FCollisionResponseContainer InitialCollisionResponses;
+
 public:
 	/** 子弹所属的队伍 */
 	UPROPERTY(BlueprintReadWrite, Category = "Projectile")
@@ -82,11 +113,56 @@ public:
 	/** 构造函数 */
 	AShooterProjectile();
 
-	/** 每帧更新：用于处理水平减速 */
-	virtual void Tick(float DeltaSeconds) override;
+	/** 生命周期结束：池化的投射物归还到池中 */
+	virtual void LifeSpanExpired() override;
+
+	/** 是否正停留在投射物池中 */
+	bool IsInPool() const { return bInPool; }
+
+	/**
+	 * 从无 Actor 模拟的命中接管：伤害与涂色已由模拟处理，这里只执行命中后的附着 / 物理行为和延迟结束
+	 * @param Hit			模拟中的命中结果
+	 * @param HitVelocity	命中时的速度
+	 */
+	void ContinueFromSimulatedHit(const FHitResult &Hit, const FVector &HitVelocity);
+
+	/**
+	 * 刚发射的投射物沿解析轨迹提前飞行一段时间（帧内开火时刻早于当前时间时补齐）
+	 * 以扫掠方式移动，途中的阻挡照常触发命中
+	 * @param FlightTime	需要补齐的飞行时间（秒）
+	 */
+	void AdvanceFlight(float FlightTime);
+
+	/**
+	 * 由投射物类的参数构造解析轨迹
+	 * @param World				提供重力
+	 * @param ProjectileClass	投射物类，参数取自其类默认对象
+	 * @param Location			发射位置
+	 * @param Direction			发射方向（单位向量）
+	 */
+	static FShooterProjectileTrajectory MakeTrajectory(const UWorld &World, TSubclassOf<AShooterProjectile> ProjectileClass, const FVector &Location, const FVector &Direction);
+
+	/**
+	 * 对命中的角色造成伤害（Actor 与无 Actor 模拟共用）
+	 * @param HitActor			被命中的 Actor
+	 * @param ProjectileOwner	投射物拥有者
+	 * @param Instigator		发射者，没有时不造成伤害
+	 * @param DamageCauser		伤害来源
+	 */
+	static void ApplyImpactDamage(AActor *HitActor, AActor *ProjectileOwner, APawn *Instigator, AActor *DamageCauser, float Damage, TSubclassOf<UDamageType> DamageType, bool bCanDamageOwner);
+
+	/**
+	 * 在命中点涂色（Actor 与无 Actor 模拟共用）
+	 * @param ImpactHit		命中结果
+	 * @param Team			涂色队伍
+	 * @param SplatRadius	大于 0 时使用球形溅射
+	 * @param OutUV			被命中表面上的 UV，供蓝图事件使用
+	 * @return				是否求得 UV（只有已注册的可涂色表面）
+	 */
+	static bool PaintImpact(UWorld *World, const FHitResult &ImpactHit, E_Team Team, float SplatRadius, FVector2D &OutUV);
 
 	// 可选的蓝图扩展事件（C++ 已实现核心涂色逻辑）
-	// 蓝图可以实现此事件添加额外的视觉效果或自定义行为
+	// 蓝图可以实现此事件添加额外的视觉效果或自定义行为；只在命中已注册的可涂色表面时触发
 	UFUNCTION(BlueprintImplementableEvent, Category = "Painting", meta = (DisplayName = "Trigger Paint On Actor"))
 	void TriggerPaintOnActor(AActor *HitActor, FVector2D HitUV, E_Team CurrentTeamID);
 
@@ -111,6 +187,18 @@ protected:
 	/** 销毁计时器回调 */
 	void OnDeferredDestruction();
 
+	/** 结束本次飞行：池化的投射物归还到池中，否则销毁 */
+	void Retire();
+
+	/** 沿 Forward 方向发射（BeginPlay 或从池中取出时） */
+	void Launch();
+
+	/** 从池中取出：恢复碰撞、移动和命中状态后发射 */
+	void ActivateFromPool(const FTransform &Transform, AActor *NewOwner, APawn *NewInstigator);
+
+	/** 放回池中：停止计时器和移动、解除附着和物理、隐藏并关闭碰撞 */
+	void EnterPool();
+
 	/** 处理涂色逻辑 */
 	void ProcessPainting(const FHitResult &ImpactHit);
 
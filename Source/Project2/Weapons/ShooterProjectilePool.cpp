@@ -0,0 +1,167 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterProjectilePool.h"
+#include "ShooterProjectile.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+void UShooterProjectilePool::Deinitialize()
+{
+	// 池中的 Actor 随世界一起销毁
+	Buckets.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShooterProjectilePool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// 只在实际游戏世界中运行
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterProjectilePool::Prewarm(TSubclassOf<AShooterProjectile> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	FShooterProjectilePoolBucket &Bucket = Buckets.FindOrAdd(ProjectileClass.Get());
+	Count = FMath::Min(Count, MaxFreePerClass);
+	Bucket.FreeList.Reserve(FMath::Max(Count, PrewarmCount));
+
+	while (Bucket.FreeList.Num() < Count)
+	{
+		AShooterProjectile *Projectile = SpawnPooled(ProjectileClass, Bucket);
+		if (!Projectile)
+		{
+			break;
+		}
+		Bucket.FreeList.Add(Projectile);
+	}
+	Bucket.Stats.Free = Bucket.FreeList.Num();
+}
+
+AShooterProjectile *UShooterProjectilePool::Acquire(TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform &Transform, AActor *Owner, APawn *Instigator)
+{
+	if (!ProjectileClass)
+	{
+		return nullptr;
+	}
+
+	FShooterProjectilePoolBucket &Bucket = Buckets.FindOrAdd(ProjectileClass.Get());
+
+	// 跳过被外部销毁的投射物
+	AShooterProjectile *Projectile = nullptr;
+	while (!Projectile && !Bucket.FreeList.IsEmpty())
+	{
+		Projectile = Bucket.FreeList.Pop(EAllowShrinking::No);
+		if (!IsValid(Projectile))
+		{
+			Projectile = nullptr;
+		}
+	}
+
+	if (Projectile)
+	{
+		++Bucket.Stats.Reused;
+	}
+	else
+	{
+		Projectile = SpawnPooled(ProjectileClass, Bucket);
+		if (!Projectile)
+		{
+			return nullptr;
+		}
+	}
+
+	Projectile->ActivateFromPool(Transform, Owner, Instigator);
+
+	++Bucket.Stats.Active;
+	Bucket.Stats.Free = Bucket.FreeList.Num();
+	Bucket.Stats.HighWaterMark = FMath::Max(Bucket.Stats.HighWaterMark, Bucket.Stats.Active);
+
+	return Projectile;
+}
+
+void UShooterProjectilePool::Release(AShooterProjectile *Projectile)
+{
+	if (!IsValid(Projectile) || Projectile->IsInPool())
+	{
+		return;
+	}
+
+	FShooterProjectilePoolBucket *Bucket = Buckets.Find(Projectile->GetClass());
+	if (!Bucket)
+	{
+		Projectile->Destroy();
+		return;
+	}
+
+	Bucket->Stats.Active = FMath::Max(Bucket->Stats.Active - 1, 0);
+
+	if (Bucket->FreeList.Num() >= MaxFreePerClass)
+	{
+		++Bucket->Stats.Destroyed;
+		Projectile->Destroy();
+		return;
+	}
+
+	Projectile->EnterPool();
+	Bucket->FreeList.Add(Projectile);
+	Bucket->Stats.Free = Bucket->FreeList.Num();
+}
+
+AShooterProjectile *UShooterProjectilePool::SpawnPooled(TSubclassOf<AShooterProjectile> ProjectileClass, FShooterProjectilePoolBucket &Bucket)
+{
+	// 延迟生成，在 BeginPlay 之前标记为池中状态
+	AShooterProjectile *Projectile = GetWorld()->SpawnActorDeferred<AShooterProjectile>(
+		ProjectileClass,
+		FTransform::Identity,
+		nullptr,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	if (!Projectile)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ShooterProjectilePool: Failed to spawn '%s'!"), *GetNameSafe(ProjectileClass.Get()));
+		return nullptr;
+	}
+
+	Projectile->bFromPool = true;
+	Projectile->bInPool = true;
+	Projectile->FinishSpawning(FTransform::Identity);
+
+	++Bucket.Stats.Spawned;
+	return Projectile;
+}
+
+FShooterProjectilePoolStats UShooterProjectilePool::GetStats(TSubclassOf<AShooterProjectile> ProjectileClass) const
+{
+	const FShooterProjectilePoolBucket *Bucket = Buckets.Find(ProjectileClass.Get());
+	return Bucket ? Bucket->Stats : FShooterProjectilePoolStats();
+}
+
+void UShooterProjectilePool::LogStats() const
+{
+	for (const TPair<TObjectPtr<UClass>, FShooterProjectilePoolBucket> &Pair : Buckets)
+	{
+		const FShooterProjectilePoolStats &Stats = Pair.Value.Stats;
+		UE_LOG(LogTemp, Log, TEXT("ShooterProjectilePool: %s Active=%d Free=%d HighWater=%d Spawned=%d Reused=%d Destroyed=%d"),
+			   *GetNameSafe(Pair.Key), Stats.Active, Stats.Free, Stats.HighWaterMark, Stats.Spawned, Stats.Reused, Stats.Destroyed);
+	}
+}
+
+// ========== 控制台命令 ==========
+
+static FAutoConsoleCommandWithWorld GShooterProjectilePoolStatsCommand(
+	TEXT("shooter.ProjectilePool.Stats"),
+	TEXT("Logs projectile pool usage per projectile class."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld *World)
+	{
+		if (const UShooterProjectilePool *Pool = UWorld::GetSubsystem<UShooterProjectilePool>(World))
+		{
+			Pool->LogStats();
+		}
+	}));
@@ -0,0 +1,112 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterProjectilePool.generated.h"
+
+class AShooterProjectile;
+class APawn;
+
+/**
+ *  单个投射物类的池统计
+ */
+USTRUCT(BlueprintType)
+struct FShooterProjectilePoolStats
+{
+	GENERATED_BODY()
+
+	/** 当前在场景中飞行或等待回收的数量 */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile Pool")
+	int32 Active = 0;
+
+	/** 池中空闲的数量 */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile Pool")
+	int32 Free = 0;
+
+	/** Active 的历史最大值 */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile Pool")
+	int32 HighWaterMark = 0;
+
+	/** 累计生成的 Actor 数（含预热） */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile Pool")
+	int32 Spawned = 0;
+
+	/** 累计从池中复用的次数 */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile Pool")
+	int32 Reused = 0;
+
+	/** 池已满而被销毁的数量 */
+	UPROPERTY(BlueprintReadOnly, Category = "Projectile Pool")
+	int32 Destroyed = 0;
+};
+
+/**
+ *  单个投射物类的空闲列表
+ */
+USTRUCT()
+struct FShooterProjectilePoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AShooterProjectile>> FreeList;
+
+	FShooterProjectilePoolStats Stats;
+};
+
+/**
+ *  投射物 Actor 池
+ *  按投射物类预热并复用 AShooterProjectile，代替每次射击 SpawnActor、命中后 Destroy
+ *  稳态下 Acquire / Release 只在空闲列表上 Pop / Push，不产生新的 Actor 或 GC 压力
+ */
+UCLASS(config = Game)
+class PROJECT2_API UShooterProjectilePool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 每个投射物类首次使用时预热的数量 */
+	UPROPERTY(Config)
+	int32 PrewarmCount = 32;
+
+	/** 每个投射物类最多保留的空闲数量，超过时归还的投射物直接销毁 */
+	UPROPERTY(Config)
+	int32 MaxFreePerClass = 256;
+
+	virtual void Deinitialize() override;
+
+	/** 为投射物类预热，使空闲数量至少为 Count */
+	void Prewarm(TSubclassOf<AShooterProjectile> ProjectileClass, int32 Count);
+
+	/**
+	 * 取出一个投射物并在指定变换处激活，池为空时生成新的 Actor
+	 * @param ProjectileClass	投射物类
+	 * @param Transform			发射变换（沿 Forward 方向飞行）
+	 * @param Owner				拥有者（通常为武器的拥有者）
+	 * @param Instigator		发射者
+	 */
+	AShooterProjectile *Acquire(TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform &Transform, AActor *Owner, APawn *Instigator);
+
+	/** 归还投射物：重置并隐藏，池已满时销毁 */
+	void Release(AShooterProjectile *Projectile);
+
+	/** 获取投射物类的统计 */
+	UFUNCTION(BlueprintPure, Category = "Projectile Pool")
+	FShooterProjectilePoolStats GetStats(TSubclassOf<AShooterProjectile> ProjectileClass) const;
+
+	/** 输出所有投射物类的统计 */
+	void LogStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** 生成一个处于池中（未激活）状态的投射物 */
+	AShooterProjectile *SpawnPooled(TSubclassOf<AShooterProjectile> ProjectileClass, FShooterProjectilePoolBucket &Bucket);
+
+	/** 投射物类 -> 空闲列表 */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FShooterProjectilePoolBucket> Buckets;
+};
@@ -0,0 +1,416 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterProjectileSimulation.h"
+#include "ShooterProjectile.h"
+#include "ShooterProjectilePool.h"
+#include "ShooterProjectileTrajectory.h"
+#include "Components/SphereComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Ink/InkStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Simulation"), STAT_ShooterProjectileSimulation, STATGROUP_Ink);
+
+void UShooterProjectileSimulation::FBatch::RemoveAtSwap(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, EAllowShrinking::No);
+	Origins.RemoveAtSwap(Index, EAllowShrinking::No);
+	LaunchVelocities.RemoveAtSwap(Index, EAllowShrinking::No);
+	Rotations.RemoveAtSwap(Index, EAllowShrinking::No);
+	LaunchTimes.RemoveAtSwap(Index, EAllowShrinking::No);
+	Ages.RemoveAtSwap(Index, EAllowShrinking::No);
+	Teams.RemoveAtSwap(Index, EAllowShrinking::No);
+	Owners.RemoveAtSwap(Index, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, EAllowShrinking::No);
+}
+
+void UShooterProjectileSimulation::Deinitialize()
+{
+	// 仍在飞行或停留的投射物不再计入存活数量
+	const int32 Remaining = GetNumFlying() + GetNumStuck();
+	InkStats::LiveProjectiles -= Remaining;
+	DEC_DWORD_STAT_BY(STAT_InkLiveProjectiles, Remaining);
+
+	Batches.Reset();
+	BatchIndices.Reset();
+	InstanceHolder = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UShooterProjectileSimulation::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// 只在实际游戏世界中运行
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterProjectileSimulation::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterProjectileSimulation, STATGROUP_Tickables);
+}
+
+bool UShooterProjectileSimulation::CanSimulate(TSubclassOf<AShooterProjectile> ProjectileClass) const
+{
+	return bEnabled && ProjectileClass && ProjectileClass->GetDefaultObject<AShooterProjectile>()->SimulationMesh;
+}
+
+bool UShooterProjectileSimulation::Launch(TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform &Transform, AActor *Owner, APawn *Instigator, E_Team Team, float FlightTime)
+{
+	return Launch(ProjectileClass, MakeArrayView(&Transform, 1), Owner, Instigator, Team, FlightTime);
+}
+
+bool UShooterProjectileSimulation::Launch(TSubclassOf<AShooterProjectile> ProjectileClass, TConstArrayView<FTransform> Transforms, AActor *Owner, APawn *Instigator, E_Team Team, float FlightTime)
+{
+	if (!CanSimulate(ProjectileClass))
+	{
+		return false;
+	}
+
+	const int32 BatchIndex = FindOrAddBatch(ProjectileClass);
+	if (BatchIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const double LaunchTime = GetWorld()->GetTimeSeconds() - FMath::Max(FlightTime, 0.0f);
+
+	FBatch &Batch = Batches[BatchIndex];
+	for (const FTransform &Transform : Transforms)
+	{
+		const FQuat Rotation = Transform.GetRotation();
+		Batch.Positions.Add(Transform.GetLocation());
+		Batch.Origins.Add(Transform.GetLocation());
+		Batch.LaunchVelocities.Add(Rotation.GetForwardVector() * Batch.Params.Speed);
+		Batch.Rotations.Add(Rotation);
+		Batch.LaunchTimes.Add(LaunchTime);
+		Batch.Ages.Add(0.0f);
+		Batch.Teams.Add(Team);
+		Batch.Owners.Add(Owner);
+		Batch.Instigators.Add(Instigator);
+	}
+
+	InkStats::LiveProjectiles += Transforms.Num();
+	INC_DWORD_STAT_BY(STAT_InkLiveProjectiles, Transforms.Num());
+	return true;
+}
+
+int32 UShooterProjectileSimulation::FindOrAddBatch(TSubclassOf<AShooterProjectile> ProjectileClass)
+{
+	if (const int32 *Found = BatchIndices.Find(ProjectileClass.Get()))
+	{
+		return *Found;
+	}
+
+	const AShooterProjectile *Defaults = ProjectileClass->GetDefaultObject<AShooterProjectile>();
+	if (!Defaults->SimulationMesh)
+	{
+		return INDEX_NONE;
+	}
+
+	// 所有实例化渲染组件挂在同一个位于原点的 Actor 上，实例变换即世界变换
+	if (!InstanceHolder)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		InstanceHolder = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!InstanceHolder)
+		{
+			return INDEX_NONE;
+		}
+
+		USceneComponent *Root = NewObject<USceneComponent>(InstanceHolder);
+		InstanceHolder->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	UInstancedStaticMeshComponent *Instances = NewObject<UInstancedStaticMeshComponent>(InstanceHolder);
+	Instances->SetStaticMesh(Defaults->SimulationMesh);
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	// 数千个小型投射物的阴影开销远大于收益
+	Instances->SetCastShadow(false);
+	Instances->SetupAttachment(InstanceHolder->GetRootComponent());
+	Instances->RegisterComponent();
+
+	FBatch &Batch = Batches.AddDefaulted_GetRef();
+	Batch.Instances = Instances;
+
+	FParams &Params = Batch.Params;
+	Params.ProjectileClass = ProjectileClass;
+	Params.Speed = Defaults->Speed;
+	Params.GravityScale = Defaults->GravityScale;
+	Params.HorizontalDeceleration = Defaults->HorizontalDeceleration;
+	Params.Radius = Defaults->CollisionComponent->GetUnscaledSphereRadius();
+	Params.HitDamage = Defaults->HitDamage;
+	Params.HitDamageType = Defaults->HitDamageType;
+	Params.bDamageOwner = Defaults->bDamageOwner;
+	Params.PaintSplatRadius = Defaults->PaintSplatRadius;
+	Params.DeferredDestructionTime = Defaults->DeferredDestructionTime;
+	Params.LifeSpan = Defaults->InitialLifeSpan > 0.0f ? Defaults->InitialLifeSpan : MaxFlightTime;
+	Params.CollisionChannel = Defaults->CollisionComponent->GetCollisionObjectType();
+	Params.ResponseParams.CollisionResponse = Defaults->CollisionComponent->GetCollisionResponseToChannels();
+	Params.MeshScale = Defaults->SimulationMeshScale;
+
+	const int32 BatchIndex = Batches.Num() - 1;
+	BatchIndices.Add(ProjectileClass.Get(), BatchIndex);
+	return BatchIndex;
+}
+
+void UShooterProjectileSimulation::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterProjectileSimulation);
+
+	for (FBatch &Batch : Batches)
+	{
+		SimulateBatch(Batch, DeltaTime);
+		UpdateInstances(Batch);
+	}
+}
+
+void UShooterProjectileSimulation::SimulateBatch(FBatch &Batch, float DeltaTime)
+{
+	// 命中静态物体后停留的投射物到时移除
+	for (int32 Index = Batch.StuckRemaining.Num() - 1; Index >= 0; --Index)
+	{
+		Batch.StuckRemaining[Index] -= DeltaTime;
+		if (Batch.StuckRemaining[Index] <= 0.0f)
+		{
+			Batch.StuckRemaining.RemoveAtSwap(Index, EAllowShrinking::No);
+			Batch.StuckTransforms.RemoveAtSwap(Index, EAllowShrinking::No);
+			--InkStats::LiveProjectiles;
+			DEC_DWORD_STAT(STAT_InkLiveProjectiles);
+		}
+	}
+
+	const int32 Num = Batch.Num();
+	if (Num == 0)
+	{
+		return;
+	}
+
+	const FParams &Params = Batch.Params;
+	const double GravityZ = GetWorld()->GetGravityZ() * Params.GravityScale;
+
+	// 忽略的 Actor 在游戏线程上解析，工作线程只读取裸指针
+	Sweeps.SetNum(Num, EAllowShrinking::No);
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Sweeps[Index].IgnoredOwner = Batch.Owners[Index].Get();
+		Sweeps[Index].IgnoredInstigator = Batch.Instigators[Index].Get();
+	}
+
+	// 按解析轨迹从已扫掠的飞行时间扫到当前时刻，结果不依赖帧率
+	// 场景查询在工作线程上只读执行，与引擎的异步 Trace 相同
+	const UWorld &World = *GetWorld();
+	const double Now = World.GetTimeSeconds();
+	ParallelFor(Num, [&](int32 Index)
+	{
+		FSweep &Sweep = Sweeps[Index];
+		const FShooterProjectileTrajectory Trajectory(Batch.Origins[Index], Batch.LaunchVelocities[Index], GravityZ, Params.HorizontalDeceleration);
+		const double StartTime = Batch.Ages[Index];
+		const double EndTime = FMath::Max(Now - Batch.LaunchTimes[Index], StartTime);
+		Sweep.EndTime = EndTime;
+
+		// 本帧刚发射、还没有飞行时间的投射物不做扫掠
+		if (EndTime <= StartTime)
+		{
+			Sweep.bHit = false;
+			Sweep.End = Trajectory.GetPosition(EndTime);
+			Sweep.Velocity = Trajectory.GetVelocity(EndTime);
+			return;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterProjectileSimulation), false);
+		QueryParams.AddIgnoredActor(Sweep.IgnoredOwner);
+		QueryParams.AddIgnoredActor(Sweep.IgnoredInstigator);
+
+		double HitTime = EndTime;
+		Sweep.bHit = Trajectory.Sweep(World, StartTime, EndTime, Params.Radius, Params.CollisionChannel, QueryParams, Params.ResponseParams, Sweep.Hit, HitTime);
+
+		Sweep.End = Trajectory.GetPosition(EndTime);
+		Sweep.Velocity = Trajectory.GetVelocity(HitTime);
+	}, Num < ParallelSweepThreshold ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// 逆序处理，RemoveAtSwap 换来的元素都已处理过
+	for (int32 Index = Num - 1; Index >= 0; --Index)
+	{
+		const FSweep &Sweep = Sweeps[Index];
+		if (Sweep.bHit)
+		{
+			// 命中时刻的速度用于命中后的物理行为
+			HandleHit(Batch, Index, Sweep.Hit, Sweep.Velocity);
+			Batch.RemoveAtSwap(Index);
+			continue;
+		}
+
+		Batch.Positions[Index] = Sweep.End;
+		Batch.Ages[Index] = static_cast<float>(Sweep.EndTime);
+
+		if (Batch.Ages[Index] >= Params.LifeSpan)
+		{
+			Batch.RemoveAtSwap(Index);
+			--InkStats::LiveProjectiles;
+			DEC_DWORD_STAT(STAT_InkLiveProjectiles);
+		}
+	}
+}
+
+void UShooterProjectileSimulation::HandleHit(FBatch &Batch, int32 Index, const FHitResult &Hit, const FVector &HitVelocity)
+{
+	const FParams &Params = Batch.Params;
+	AActor *Owner = Batch.Owners[Index].Get();
+	APawn *Instigator = Batch.Instigators[Index].Get();
+	const E_Team Team = Batch.Teams[Index];
+
+	// 没有投射物 Actor，伤害来源记为拥有者
+	AShooterProjectile::ApplyImpactDamage(Hit.GetActor(), Owner, Instigator, Owner, Params.HitDamage, Params.HitDamageType, Params.bDamageOwner);
+
+	FVector2D UV;
+	AShooterProjectile::PaintImpact(GetWorld(), Hit, Team, Params.PaintSplatRadius, UV);
+
+	UPrimitiveComponent *HitComp = Hit.GetComponent();
+	if (HitComp && HitComp->Mobility == EComponentMobility::Static)
+	{
+		// 静态物体：原地停留，与附着到静态目标的 Actor 相同
+		if (Params.DeferredDestructionTime > 0.0f)
+		{
+			Batch.StuckTransforms.Add(FTransform(Batch.Rotations[Index], Hit.Location, Params.MeshScale));
+			Batch.StuckRemaining.Add(Params.DeferredDestructionTime);
+			return;
+		}
+	}
+	else if (HitComp)
+	{
+		// 可移动物体：交给投射物 Actor 继续物理模拟（由它自己计入存活数量）
+		const FTransform HitTransform(Batch.Rotations[Index], Hit.Location);
+		AShooterProjectile *Projectile = nullptr;
+		if (UShooterProjectilePool *Pool = GetWorld()->GetSubsystem<UShooterProjectilePool>())
+		{
+			Projectile = Pool->Acquire(Params.ProjectileClass, HitTransform, Owner, Instigator);
+		}
+		else
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnParams.Owner = Owner;
+			SpawnParams.Instigator = Instigator;
+			Projectile = GetWorld()->SpawnActor<AShooterProjectile>(Params.ProjectileClass, HitTransform, SpawnParams);
+		}
+
+		if (Projectile)
+		{
+			Projectile->OwningTeam = Team;
+			Projectile->ContinueFromSimulatedHit(Hit, HitVelocity);
+		}
+	}
+
+	--InkStats::LiveProjectiles;
+	DEC_DWORD_STAT(STAT_InkLiveProjectiles);
+}
+
+void UShooterProjectileSimulation::UpdateInstances(FBatch &Batch)
+{
+	UInstancedStaticMeshComponent *Instances = Batch.Instances.Get();
+	if (!Instances)
+	{
+		return;
+	}
+
+	// 连续没有投射物时不再重复写入
+	const int32 NumVisible = Batch.Num() + Batch.StuckTransforms.Num();
+	if (NumVisible == 0 && Batch.LastNumVisible == 0)
+	{
+		return;
+	}
+	Batch.LastNumVisible = NumVisible;
+
+	const int32 NumInstances = Instances->GetInstanceCount();
+
+	const FVector Scale = Batch.Params.MeshScale;
+	InstanceTransforms.Reset();
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		InstanceTransforms.Emplace(Batch.Rotations[Index], Batch.Positions[Index], Scale);
+	}
+	InstanceTransforms.Append(Batch.StuckTransforms);
+
+	if (NumVisible > NumInstances)
+	{
+		// 实例数只增不减，新增的部分直接以当前变换添加
+		TArray<FTransform> NewTransforms(InstanceTransforms.GetData() + NumInstances, NumVisible - NumInstances);
+		Instances->AddInstances(NewTransforms, false, true);
+		InstanceTransforms.SetNum(NumInstances, EAllowShrinking::No);
+	}
+	else
+	{
+		// 多余的实例缩放为 0
+		InstanceTransforms.SetNum(NumInstances, EAllowShrinking::No);
+		for (int32 Index = NumVisible; Index < NumInstances; ++Index)
+		{
+			InstanceTransforms[Index] = FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+		}
+	}
+
+	if (!InstanceTransforms.IsEmpty())
+	{
+		Instances->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+	}
+}
+
+int32 UShooterProjectileSimulation::GetNumFlying() const
+{
+	int32 Num = 0;
+	for (const FBatch &Batch : Batches)
+	{
+		Num += Batch.Num();
+	}
+	return Num;
+}
+
+int32 UShooterProjectileSimulation::GetNumStuck() const
+{
+	int32 Num = 0;
+	for (const FBatch &Batch : Batches)
+	{
+		Num += Batch.StuckTransforms.Num();
+	}
+	return Num;
+}
+
+void UShooterProjectileSimulation::LogStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("ShooterProjectileSimulation: Enabled=%d Flying=%d Stuck=%d"), bEnabled, GetNumFlying(), GetNumStuck());
+	for (const FBatch &Batch : Batches)
+	{
+		const UInstancedStaticMeshComponent *Instances = Batch.Instances.Get();
+		UE_LOG(LogTemp, Log, TEXT("  %s Flying=%d Stuck=%d Instances=%d"),
+			   *GetNameSafe(Batch.Params.ProjectileClass.Get()), Batch.Num(), Batch.StuckTransforms.Num(), Instances ? Instances->GetInstanceCount() : 0);
+	}
+}
+
+// ========== 控制台命令 ==========
+
+static FAutoConsoleCommandWithWorld GShooterProjectileSimulationStatsCommand(
+	TEXT("shooter.ProjectileSim.Stats"),
+	TEXT("Logs actorless projectile counts per projectile class."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld *World)
+	{
+		if (const UShooterProjectileSimulation *Simulation = UWorld::GetSubsystem<UShooterProjectileSimulation>(World))
+		{
+			Simulation->LogStats();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GShooterProjectileSimulationEnableCommand(
+	TEXT("shooter.ProjectileSim.Enable"),
+	TEXT("Enables or disables actorless projectile simulation. Usage: shooter.ProjectileSim.Enable 0|1"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString> &Args, UWorld *World)
+	{
+		if (UShooterProjectileSimulation *Simulation = UWorld::GetSubsystem<UShooterProjectileSimulation>(World))
+		{
+			Simulation->SetEnabled(Args.Num() == 0 || FCString::Atoi(*Args[0]) != 0);
+		}
+	}));
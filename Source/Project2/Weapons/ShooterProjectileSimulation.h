@@ -0,0 +1,178 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CollisionQueryParams.h"
+#include "ShooterGameMode.h"
+#include "ShooterProjectileSimulation.generated.h"
+
+class AShooterProjectile;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+class UDamageType;
+class APawn;
+
+/**
+ *  无 Actor 投射物模拟
+ *  由世界子系统以 SoA（结构数组）持有所有飞行中的投射物，按投射物类分批：
+ *  - 一个循环按解析轨迹（FShooterProjectileTrajectory，重力 + 水平指数衰减）求值并分段扫掠，不依赖帧率，扫掠在工作线程上并行
+ *  - 命中在游戏线程上处理：伤害（ApplyDamage）、涂色与 Actor 模式相同；
+ *    命中静态物体后原地停留 DeferredDestructionTime，命中可移动物体时交给池中的 AShooterProjectile 继续物理模拟
+ *  - 每个投射物类一个 UInstancedStaticMeshComponent 渲染（使用类默认对象的 SimulationMesh）
+ *
+ *  蓝图事件（TriggerPaintOnActor / BP_OnProjectileHit）没有 Actor 可以调用，不会触发
+ */
+UCLASS(config = Game)
+class PROJECT2_API UShooterProjectileSimulation : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** 是否启用无 Actor 模拟（武器开火时优先使用），运行时可用 SetEnabled 切换 */
+	UPROPERTY(Config)
+	bool bEnabled = false;
+
+	/** 投射物类未设置 InitialLifeSpan 时的最长飞行时间（秒） */
+	UPROPERTY(Config)
+	float MaxFlightTime = 10.0f;
+
+	/** 投射物数量达到该值时扫掠检测分到多个工作线程 */
+	UPROPERTY(Config)
+	int32 ParallelSweepThreshold = 64;
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** 启用 / 关闭无 Actor 模拟，关闭后已经在飞行的投射物继续模拟直到结束 */
+	UFUNCTION(BlueprintCallable, Category = "Projectile Simulation")
+	void SetEnabled(bool bInEnabled) { bEnabled = bInEnabled; }
+
+	/** 投射物类是否可以使用无 Actor 模拟（已启用且设置了 SimulationMesh） */
+	bool CanSimulate(TSubclassOf<AShooterProjectile> ProjectileClass) const;
+
+	/**
+	 * 发射一个无 Actor 投射物
+	 * @param ProjectileClass	投射物类，参数取自其类默认对象
+	 * @param Transform			发射变换（沿 Forward 方向飞行）
+	 * @param Owner				拥有者
+	 * @param Instigator		发射者
+	 * @param Team				涂色队伍
+	 * @param FlightTime		发射时刻早于当前世界时间的秒数（帧内开火），下一次模拟从该时刻开始扫掠
+	 * @return					类不支持无 Actor 模拟时返回 false
+	 */
+	bool Launch(TSubclassOf<AShooterProjectile> ProjectileClass, const FTransform &Transform, AActor *Owner, APawn *Instigator, E_Team Team, float FlightTime = 0.0f);
+
+	/**
+	 * 一次发射一批同类投射物（多弹丸齐射），批次查找和延迟补偿查询只做一次
+	 * @param Transforms	每颗投射物的发射变换
+	 */
+	bool Launch(TSubclassOf<AShooterProjectile> ProjectileClass, TConstArrayView<FTransform> Transforms, AActor *Owner, APawn *Instigator, E_Team Team, float FlightTime = 0.0f);
+
+	/** 飞行中的投射物数量 */
+	int32 GetNumFlying() const;
+
+	/** 命中静态物体后停留的投射物数量 */
+	int32 GetNumStuck() const;
+
+	/** 输出各投射物类的数量 */
+	void LogStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** 从类默认对象读取的参数 */
+	struct FParams
+	{
+		TSubclassOf<AShooterProjectile> ProjectileClass;
+		float Speed = 0.0f;
+		float GravityScale = 0.0f;
+		float HorizontalDeceleration = 0.0f;
+		float Radius = 0.0f;
+		float HitDamage = 0.0f;
+		TSubclassOf<UDamageType> HitDamageType;
+		bool bDamageOwner = false;
+		float PaintSplatRadius = 0.0f;
+		float DeferredDestructionTime = 0.0f;
+		float LifeSpan = 0.0f;
+		ECollisionChannel CollisionChannel = ECC_WorldDynamic;
+		FCollisionResponseParams ResponseParams;
+
+		FVector MeshScale = FVector::OneVector;
+	};
+
+	/** 一个投射物类的所有投射物（SoA，下标一一对应） */
+	struct FBatch
+	{
+		FParams Params;
+
+		/** 实例化渲染组件，实例数只增不减，多余的实例缩放为 0 */
+		TWeakObjectPtr<UInstancedStaticMeshComponent> Instances;
+
+		// 飞行中：发射状态 + 发射时刻，位置由 FShooterProjectileTrajectory 求值（Positions 为缓存，供渲染）
+		// 每次模拟从已扫掠的飞行时间 Ages 扫到 当前时间 - LaunchTimes，与子系统的 Tick 顺序和帧率无关
+		TArray<FVector> Positions;
+		TArray<FVector> Origins;
+		TArray<FVector> LaunchVelocities;
+		TArray<FQuat> Rotations;
+		TArray<double> LaunchTimes;
+		TArray<float> Ages;
+		TArray<E_Team> Teams;
+		TArray<TWeakObjectPtr<AActor>> Owners;
+		TArray<TWeakObjectPtr<APawn>> Instigators;
+
+		// 命中静态物体后停留
+		TArray<FTransform> StuckTransforms;
+		TArray<float> StuckRemaining;
+
+		/** 上一帧可见的实例数 */
+		int32 LastNumVisible = 0;
+
+		int32 Num() const { return Positions.Num(); }
+		void RemoveAtSwap(int32 Index);
+	};
+
+	/** 一次扫掠的结果 */
+	struct FSweep
+	{
+		const AActor *IgnoredOwner = nullptr;
+		const AActor *IgnoredInstigator = nullptr;
+		/** 本帧结束时的飞行时间和位置 */
+		double EndTime = 0.0;
+		FVector End;
+
+		/** 命中时刻（未命中时为本帧结束时）的速度 */
+		FVector Velocity;
+		FHitResult Hit;
+		bool bHit = false;
+	};
+
+	/** 获取（必要时创建）投射物类的批次，类不支持时返回 INDEX_NONE */
+	int32 FindOrAddBatch(TSubclassOf<AShooterProjectile> ProjectileClass);
+
+	/** 积分并扫掠一个批次，处理命中和超时 */
+	void SimulateBatch(FBatch &Batch, float DeltaTime);
+
+	/** 处理一次命中：伤害、涂色、命中后行为 */
+	void HandleHit(FBatch &Batch, int32 Index, const FHitResult &Hit, const FVector &HitVelocity);
+
+	/** 更新实例化渲染 */
+	void UpdateInstances(FBatch &Batch);
+
+	TArray<FBatch> Batches;
+	TMap<TObjectKey<UClass>, int32> BatchIndices;
+
+	/** 持有实例化渲染组件的 Actor */
+	UPROPERTY()
+	TObjectPtr<AActor> InstanceHolder;
+
+	// 逐帧复用的临时数组
+	TArray<FSweep> Sweeps;
+	TArray<FTransform> InstanceTransforms;
+};
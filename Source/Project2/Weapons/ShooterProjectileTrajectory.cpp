@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterProjectileTrajectory.h"
+#include "Engine/World.h"
+
+namespace ShooterProjectileTrajectory
+{
+	/** k t 小于该值时用泰勒展开代替 (1 - e^(-k t)) / k，避免相减抵消 */
+	constexpr double SmallDecay = 1e-4;
+
+	/** (1 - e^(-k t)) / k，k -> 0 时趋于 t */
+	double DecayIntegral(double Deceleration, double Time)
+	{
+		const double KT = Deceleration * Time;
+		if (KT < SmallDecay)
+		{
+			return Time * (1.0 - KT * (0.5 - KT / 6.0));
+		}
+		return (1.0 - FMath::Exp(-KT)) / Deceleration;
+	}
+}
+
+FVector FShooterProjectileTrajectory::GetPosition(double Time) const
+{
+	const double Horizontal = ShooterProjectileTrajectory::DecayIntegral(Deceleration, Time);
+	return FVector(
+		Origin.X + Velocity.X * Horizontal,
+		Origin.Y + Velocity.Y * Horizontal,
+		Origin.Z + Velocity.Z * Time + 0.5 * GravityZ * Time * Time);
+}
+
+FVector FShooterProjectileTrajectory::GetVelocity(double Time) const
+{
+	const double Decay = FMath::Exp(-Deceleration * Time);
+	return FVector(Velocity.X * Decay, Velocity.Y * Decay, Velocity.Z + GravityZ * Time);
+}
+
+double FShooterProjectileTrajectory::GetAccelerationSize(double Time) const
+{
+	// 水平加速度 -k * v_h(t)，竖直加速度 g
+	const double Horizontal = Deceleration * FMath::Exp(-Deceleration * Time) * FVector2D(Velocity.X, Velocity.Y).Size();
+	return FMath::Sqrt(Horizontal * Horizontal + GravityZ * GravityZ);
+}
+
+void FShooterProjectileTrajectory::SamplePositions(double StartTime, double EndTime, int32 NumPoints, TArray<FVector> &OutPoints) const
+{
+	NumPoints = FMath::Max(NumPoints, 2);
+	OutPoints.Reset(NumPoints);
+
+	const double Step = (EndTime - StartTime) / (NumPoints - 1);
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		OutPoints.Add(GetPosition(StartTime + Step * Index));
+	}
+}
+
+bool FShooterProjectileTrajectory::Sweep(const UWorld &World, double StartTime, double EndTime, float Radius, ECollisionChannel Channel,
+										 const FCollisionQueryParams &QueryParams, const FCollisionResponseParams &ResponseParams,
+										 FHitResult &OutHit, double &OutHitTime, float Tolerance, int32 MaxSegments) const
+{
+	const double Duration = EndTime - StartTime;
+	if (Duration <= 0.0)
+	{
+		return false;
+	}
+
+	// 加速度随时间单调不增，起点处的值是整个区间的上界
+	// 弦与曲线的最大偏差 <= a_max * h^2 / 8，据此求出满足 Tolerance 的最少段数
+	const double MaxAcceleration = GetAccelerationSize(StartTime);
+	const double Tol = FMath::Max(static_cast<double>(Tolerance), UE_KINDA_SMALL_NUMBER);
+	const int32 NeededSegments = FMath::CeilToInt32(Duration * FMath::Sqrt(MaxAcceleration / (8.0 * Tol)));
+	const int32 NumSegments = FMath::Clamp(NeededSegments, 1, FMath::Max(MaxSegments, 1));
+
+	// 段数受限时把剩余偏差加到半径上，保证保守
+	const double SegmentDuration = Duration / NumSegments;
+	const double Deviation = MaxAcceleration * SegmentDuration * SegmentDuration / 8.0;
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(Radius + static_cast<float>(FMath::Max(Deviation - Tol, 0.0)));
+
+	FVector SegmentStart = GetPosition(StartTime);
+	for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+	{
+		const double SegmentStartTime = StartTime + SegmentDuration * Segment;
+		const FVector SegmentEnd = GetPosition(SegmentStartTime + SegmentDuration);
+
+		if (World.SweepSingleByChannel(OutHit, SegmentStart, SegmentEnd, FQuat::Identity, Channel, Shape, QueryParams, ResponseParams))
+		{
+			OutHitTime = SegmentStartTime + SegmentDuration * OutHit.Time;
+			return true;
+		}
+
+		SegmentStart = SegmentEnd;
+	}
+
+	return false;
+}
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+
+class UWorld;
+
+/**
+ *  投射物轨迹的解析解
+ *  水平速度按 exp(-k t) 衰减，竖直方向受恒定重力：
+ *    v_h(t) = v0_h * e^(-k t)				p_h(t) = p0_h + v0_h * (1 - e^(-k t)) / k
+ *    v_z(t) = v0_z + g t					p_z(t) = p0_z + v0_z t + g t^2 / 2
+ *  与 UInkProjectileMovementComponent 的逐子步结果一致，可在任意时刻直接求值
+ *  用于轨迹预览、服务器回溯和无 Actor 模拟
+ */
+struct PROJECT2_API FShooterProjectileTrajectory
+{
+	/** 发射位置 */
+	FVector Origin = FVector::ZeroVector;
+
+	/** 发射速度 */
+	FVector Velocity = FVector::ZeroVector;
+
+	/** 竖直加速度（世界重力 * 重力系数，向下为负） */
+	double GravityZ = 0.0;
+
+	/** 水平衰减率 k（每秒） */
+	double Deceleration = 0.0;
+
+	FShooterProjectileTrajectory() = default;
+
+	FShooterProjectileTrajectory(const FVector &InOrigin, const FVector &InVelocity, double InGravityZ, double InDeceleration)
+		: Origin(InOrigin), Velocity(InVelocity), GravityZ(InGravityZ), Deceleration(FMath::Max(InDeceleration, 0.0))
+	{
+	}
+
+	/** t 秒后的位置 */
+	FVector GetPosition(double Time) const;
+
+	/** t 秒后的速度 */
+	FVector GetVelocity(double Time) const;
+
+	/** t 秒后的加速度大小（水平衰减与重力的合成），随时间单调不增 */
+	double GetAccelerationSize(double Time) const;
+
+	/**
+	 * 在 [StartTime, EndTime] 内等间隔采样轨迹点（含两端），用于预览弧线
+	 * @param NumPoints	采样点数，至少为 2
+	 */
+	void SamplePositions(double StartTime, double EndTime, int32 NumPoints, TArray<FVector> &OutPoints) const;
+
+	/**
+	 * 以少量直线段保守地扫掠 [StartTime, EndTime] 内的轨迹
+	 * 每段按弦与曲线的最大偏差 a_max * h^2 / 8 决定分段数，达到 MaxSegments 后把剩余偏差加到球半径上，
+	 * 因此不会漏掉真实轨迹扫过的物体
+	 * @param World			查询的世界
+	 * @param Radius		投射物半径
+	 * @param Tolerance		不加大半径时允许的偏差（cm）
+	 * @param OutHit		命中结果
+	 * @param OutHitTime	命中时刻
+	 * @return				是否命中
+	 */
+	bool Sweep(const UWorld &World, double StartTime, double EndTime, float Radius, ECollisionChannel Channel,
+			   const FCollisionQueryParams &QueryParams, const FCollisionResponseParams &ResponseParams,
+			   FHitResult &OutHit, double &OutHitTime, float Tolerance = 1.0f, int32 MaxSegments = 4) const;
+};
@@ -4,12 +4,18 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterProjectile.h"
+#include "ShooterProjectilePool.h"
+#include "ShooterProjectileSimulation.h"
+#include "ShooterProjectileTrajectory.h"
+#include "ShooterFireScheduler.h"
 #include "ShooterWeaponHolder.h"
 #include "Components/SceneComponent.h"
 #include "TimerManager.h"
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Character/ShooterCharacter.h"
+#include "GameFramework/PlayerState.h"
+#include "ShooterGameState.h"
 
 AShooterWeapon::AShooterWeapon()
 {
@@ -50,14 +56,24 @@ void AShooterWeapon::BeginPlay()
 
 	// 将网格附加给角色
 	WeaponOwner->AttachWeaponMeshes(this);
+
+	// 预热投射物池，避免首次开火时集中生成
+	if (UShooterProjectilePool *Pool = GetWorld()->GetSubsystem<UShooterProjectilePool>())
+	{
+		Pool->Prewarm(ProjectileClass, Pool->PrewarmCount);
+	}
 }
 
 void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	// 清空射击计时器
+	// 清空射击计时器并退出调度
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
+	if (UShooterFireScheduler *Scheduler = GetWorld()->GetSubsystem<UShooterFireScheduler>())
+	{
+		Scheduler->StopFiring(this);
+	}
 }
 
 void AShooterWeapon::OnOwnerDestroyed(AActor *DestroyedActor)
@@ -104,11 +120,10 @@ void AShooterWeapon::StartFiring()
 	else
 	{
 
-		// 全自动武器需要等待剩余的冷却时间
+		// 全自动武器在冷却结束的时刻由调度器开火
 		if (bFullAuto)
 		{
-			const float RemainingCooldown = RefireRate - TimeSinceLastShot;
-			GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, RemainingCooldown, false);
+			ScheduleFullAuto(TimeOfLastShot + RefireRate);
 		}
 	}
 }
@@ -118,16 +133,40 @@ void AShooterWeapon::StopFiring()
 	// 取消开火状态
 	bIsFiring = false;
 
-	// 清除射击计时器
+	// 清除射击计时器并退出调度
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
+	if (UShooterFireScheduler *Scheduler = GetWorld()->GetSubsystem<UShooterFireScheduler>())
+	{
+		Scheduler->StopFiring(this);
+	}
 }
 
 void AShooterWeapon::Fire()
+{
+	if (!FireShot(0.0f))
+	{
+		return;
+	}
+
+	// 全自动模式会继续调度射击
+	if (bFullAuto)
+	{
+		// 后续射击由调度器按理论开火时刻发出
+		ScheduleFullAuto(TimeOfLastShot + RefireRate);
+	}
+	else
+	{
+		// 半自动武器到时间后通知上层
+		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::FireCooldownExpired, RefireRate, false);
+	}
+}
+
+bool AShooterWeapon::FireShot(float ShotAge)
 {
 	// 如果玩家松开扳机则停止继续射击
 	if (!bIsFiring)
 	{
-		return;
+		return false;
 	}
 
 	// 检查弹药是否耗尽
@@ -139,25 +178,28 @@ void AShooterWeapon::Fire()
 
 		// 本次不射击，等待下次触发
 		// 可在此处播放换弹音效/动画
-		return;
+		return false;
 	}
 
-	// 向目标位置发射投射物
-	FireProjectile(WeaponOwner->GetWeaponTargetLocation());
+	// 向目标位置发射投射物，射击序号随本次射击一起传递
+	FireProjectile(WeaponOwner->GetWeaponTargetLocation(), ShotAge, ShotIndex++);
 
-	// 记录本次开火时间
-	TimeOfLastShot = GetWorld()->GetTimeSeconds();
+	// 记录本次开火时间（帧内补发时为理论开火时刻）
+	TimeOfLastShot = GetWorld()->GetTimeSeconds() - ShotAge;
+	return true;
+}
 
-	// 全自动模式会继续调度射击
-	if (bFullAuto)
+void AShooterWeapon::ScheduleFullAuto(double NextShotTime)
+{
+	if (UShooterFireScheduler *Scheduler = GetWorld()->GetSubsystem<UShooterFireScheduler>())
 	{
-		// 继续定时射击
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, RefireRate, false);
+		Scheduler->StartFiring(this, NextShotTime);
 	}
 	else
 	{
-		// 半自动武器到时间后通知上层
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::FireCooldownExpired, RefireRate, false);
+		// 没有调度器时退回逐发计时
+		const float Delay = FMath::Max(static_cast<float>(NextShotTime - GetWorld()->GetTimeSeconds()), UE_KINDA_SMALL_NUMBER);
+		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, Delay, false);
 	}
 }
 
@@ -167,7 +209,7 @@ void AShooterWeapon::FireCooldownExpired()
 	WeaponOwner->OnSemiWeaponRefire();
 }
 
-void AShooterWeapon::FireProjectile(const FVector &TargetLocation)
+void AShooterWeapon::FireProjectile(const FVector &TargetLocation, float ShotAge, uint32 InShotIndex)
 {
 	// 检查投射物类是否有效
 	if (!ProjectileClass)
@@ -175,27 +217,51 @@ void AShooterWeapon::FireProjectile(const FVector &TargetLocation)
 		return;
 	}
 
-	// 计算投射物生成变换
-	FTransform ProjectileTransform = CalculateProjectileSpawnTransform(TargetLocation);
+	// 本次射击的散布由 (对局种子, 射击者, 射击序号) 决定；种子经 GameState 同步，客户端与服务器一致
+	const AShooterGameState *GameState = GetWorld()->GetGameState<AShooterGameState>();
+	SpreadStream = MakeSpreadStream(GameState ? GameState->GetMatchSeed() : 0, GetShooterId(), InShotIndex);
 
-	// 生成投射物
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
-	SpawnParams.Owner = GetOwner();
-	SpawnParams.Instigator = Cast<APawn>(GetOwner());
+	// 整次齐射共用一次瞄准结果
+	CalculatePelletTransforms(TargetLocation, PelletTransforms);
 
-	AShooterProjectile *Projectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	const AShooterCharacter *ShooterChar = Cast<AShooterCharacter>(GetOwner());
+	const E_Team Team = ShooterChar ? ShooterChar->GetTeam() : E_Team::None;
+	APawn *InstigatorPawn = Cast<APawn>(GetOwner());
 
-	// 设置投射物的队伍属性
-	if (Projectile)
+	// 启用无 Actor 模拟且投射物类支持时整批加入模拟，不生成 Actor
+	UShooterProjectileSimulation *Simulation = GetWorld()->GetSubsystem<UShooterProjectileSimulation>();
+	if (!Simulation || !Simulation->Launch(ProjectileClass, PelletTransforms, GetOwner(), InstigatorPawn, Team, ShotAge))
 	{
-		if (AShooterCharacter *ShooterChar = Cast<AShooterCharacter>(GetOwner()))
+		// 优先从投射物池中取出，没有池时退回直接生成
+		UShooterProjectilePool *Pool = GetWorld()->GetSubsystem<UShooterProjectilePool>();
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
+		SpawnParams.Owner = GetOwner();
+		SpawnParams.Instigator = InstigatorPawn;
+
+		for (const FTransform &PelletTransform : PelletTransforms)
 		{
-			Projectile->OwningTeam = ShooterChar->GetTeam();
+			AShooterProjectile *Projectile = Pool
+				? Pool->Acquire(ProjectileClass, PelletTransform, GetOwner(), InstigatorPawn)
+				: GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, PelletTransform, SpawnParams);
+
+			// 设置投射物的队伍属性
+			if (Projectile && ShooterChar)
+			{
+				Projectile->OwningTeam = Team;
+			}
+
+			// 帧内开火：补齐从开火时刻到现在的飞行
+			if (Projectile)
+			{
+				Projectile->AdvanceFlight(ShotAge);
+			}
 		}
 	}
 
+	// 动画、后坐力、弹药和 HUD 每次齐射只处理一次
 	// 播放射击动画
 	WeaponOwner->PlayFiringMontage(FiringMontage);
 
@@ -218,12 +284,95 @@ FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector &Targ
 	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * MuzzleOffset);
 
 	// 计算带随机散布的朝向
-	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (UKismetMathLibrary::RandomUnitVector() * AimVariance));
+	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (SpreadStream.VRand() * AimVariance));
 
 	// 返回最终变换
 	return FTransform(AimRot, SpawnLoc, FVector::OneVector);
 }
 
+void AShooterWeapon::CalculatePelletTransforms(const FVector &TargetLocation, TArray<FTransform> &OutTransforms) const
+{
+	OutTransforms.Reset();
+
+	// 齐射中心（含瞄准散布）
+	const FTransform CenterTransform = CalculateProjectileSpawnTransform(TargetLocation);
+	if (PelletCount <= 1)
+	{
+		OutTransforms.Add(CenterTransform);
+		return;
+	}
+
+	const FQuat AimQuat = CenterTransform.GetRotation();
+	const FVector SpawnLoc = CenterTransform.GetLocation();
+	const float SpreadRad = FMath::DegreesToRadians(PelletSpread);
+
+	for (int32 Index = 0; Index < PelletCount; ++Index)
+	{
+		// 局部坐标系下的方向（X 为瞄准方向）
+		FVector LocalDir = FVector::ForwardVector;
+		switch (SpreadPattern)
+		{
+		case EShooterSpreadPattern::Random:
+			LocalDir = SpreadStream.VRandCone(FVector::ForwardVector, SpreadRad);
+			break;
+
+		case EShooterSpreadPattern::Ring:
+			// 第一颗居中，其余等分圆环
+			if (Index > 0)
+			{
+				const float Phi = UE_TWO_PI * (Index - 1) / (PelletCount - 1);
+				LocalDir = FVector(FMath::Cos(SpreadRad), FMath::Sin(SpreadRad) * FMath::Cos(Phi), FMath::Sin(SpreadRad) * FMath::Sin(Phi));
+			}
+			break;
+
+		case EShooterSpreadPattern::Fan:
+		{
+			const float Yaw = FMath::Lerp(-SpreadRad, SpreadRad, static_cast<float>(Index) / (PelletCount - 1));
+			LocalDir = FVector(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.0f);
+			break;
+		}
+		}
+
+		const FVector Direction = AimQuat.RotateVector(LocalDir);
+		OutTransforms.Emplace(Direction.Rotation(), SpawnLoc, FVector::OneVector);
+	}
+}
+
+FRandomStream AShooterWeapon::MakeSpreadStream(int32 MatchSeed, int32 ShooterId, uint32 InShotIndex)
+{
+	const uint32 Seed = HashCombineFast(HashCombineFast(static_cast<uint32>(MatchSeed), static_cast<uint32>(ShooterId)), InShotIndex);
+	return FRandomStream(static_cast<int32>(Seed));
+}
+
+int32 AShooterWeapon::GetShooterId() const
+{
+	const APawn *Pawn = Cast<APawn>(GetOwner());
+	if (const APlayerState *PlayerState = Pawn ? Pawn->GetPlayerState() : nullptr)
+	{
+		return PlayerState->GetPlayerId();
+	}
+
+	// 对象 ID 只在本机稳定，不能用于跨端重建散布
+	return 0;
+}
+
+void AShooterWeapon::GetTrajectoryPreview(float Duration, int32 NumPoints, TArray<FVector> &OutPoints) const
+{
+	OutPoints.Reset();
+	if (!ProjectileClass || !WeaponOwner)
+	{
+		return;
+	}
+
+	// 与 CalculateProjectileSpawnTransform 相同的生成点，但不加随机散布
+	const FVector TargetLocation = WeaponOwner->GetWeaponTargetLocation();
+	const FVector MuzzleLoc = FirstPersonMesh->GetSocketLocation(MuzzleSocketName);
+	const FVector Direction = (TargetLocation - MuzzleLoc).GetSafeNormal();
+
+	const FShooterProjectileTrajectory Trajectory = AShooterProjectile::MakeTrajectory(*GetWorld(), ProjectileClass, MuzzleLoc + Direction * MuzzleOffset, Direction);
+	Trajectory.SamplePositions(0.0, Duration, NumPoints, OutPoints);
+}
+
 const TSubclassOf<UAnimInstance> &AShooterWeapon::GetFirstPersonAnimInstanceClass() const
 {
 	return FirstPersonAnimInstanceClass;
@@ -14,6 +14,20 @@ class USkeletalMeshComponent;
 class UAnimMontage;
 class UAnimInstance;
 
+/** 多弹丸武器一次齐射的散布形状 */
+UENUM(BlueprintType)
+enum class EShooterSpreadPattern : uint8
+{
+	/** 每颗弹丸在散布锥内随机取方向 */
+	Random UMETA(DisplayName = "Random Cone"),
+
+	/** 一颗居中，其余均匀分布在散布角的圆环上 */
+	Ring UMETA(DisplayName = "Ring"),
+
+	/** 在水平面内从 -散布角 到 +散布角 均匀展开 */
+	Fan UMETA(DisplayName = "Horizontal Fan")
+};
+
 /**
  *  简单第一人称射击武器基类
  *  同时提供第一人称与第三人称网格
@@ -25,6 +39,8 @@ class PROJECT2_API AShooterWeapon : public AActor
 {
 	GENERATED_BODY()
 
+	friend class UShooterFireScheduler;
+
 	/** 第一人称网格 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	USkeletalMeshComponent *FirstPersonMesh;
@@ -64,6 +80,18 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Aim", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
 	float AimVariance = 0.0f;
 
+	/** 每次射击发射的弹丸数（霰弹 / 喷射类武器大于 1），整次齐射只消耗一发弹药 */
+	UPROPERTY(EditAnywhere, Category = "Aim|Pellets", meta = (ClampMin = 1, ClampMax = 32))
+	int32 PelletCount = 1;
+
+	/** 弹丸相对瞄准方向的散布半角 */
+	UPROPERTY(EditAnywhere, Category = "Aim|Pellets", meta = (ClampMin = 0, ClampMax = 45, Units = "Degrees", EditCondition = "PelletCount > 1"))
+	float PelletSpread = 5.0f;
+
+	/** 弹丸的散布形状 */
+	UPROPERTY(EditAnywhere, Category = "Aim|Pellets", meta = (EditCondition = "PelletCount > 1"))
+	EShooterSpreadPattern SpreadPattern = EShooterSpreadPattern::Random;
+
 	/** 射击后施加给持有者的后坐力大小 */
 	UPROPERTY(EditAnywhere, Category = "Aim", meta = (ClampMin = 0, ClampMax = 100))
 	float FiringRecoil = 0.0f;
@@ -80,8 +108,11 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Refire")
 	bool bFullAuto = false;
 
-	/** 射击间隔（秒），影响全/半自动 */
-	UPROPERTY(EditAnywhere, Category = "Refire", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	/**
+	 * 射击间隔（秒），影响全/半自动；全自动可以小于一帧，由 UShooterFireScheduler 在一帧内发出多发
+	 * 下限 0.01 秒（每秒 100 发），在每帧 8 发的上限下 12.5 帧以上都能保持射速
+	 */
+	UPROPERTY(EditAnywhere, Category = "Refire", meta = (ClampMin = 0.01, ClampMax = 5, Units = "s"))
 	float RefireRate = 0.5f;
 
 	/** 上一次开火的游戏时间，用于半自动节奏控制 */
@@ -90,9 +121,18 @@ protected:
 	/** 当前武器是否仍保持射击状态（按住扳机时为 true） */
 	bool bIsFiring = false;
 
-	/** 全自动射击的计时器 */
+	/** 半自动冷却及全自动冷却等待的计时器（全自动的连续射击由 UShooterFireScheduler 调度） */
 	FTimerHandle RefireTimer;
 
+	/** 逐次齐射复用的弹丸变换 */
+	TArray<FTransform> PelletTransforms;
+
+	/** 散布随机数流，每次射击前按 (对局种子, 射击者, 射击序号) 重新播种 */
+	FRandomStream SpreadStream;
+
+	/** 下一次射击的序号，每次射击占用一个并随射击传给 FireProjectile */
+	uint32 ShotIndex = 0;
+
 public:
 	/** 构造函数 */
 	AShooterWeapon();
@@ -123,18 +163,38 @@ public:
 	void StopFiring();
 
 protected:
-	/** 负责一次射击的全部流程：生成投射物、播放反馈、消耗弹药 */
+	/** 扳机按下或冷却结束时的射击：立即开火，全自动武器随后交给 UShooterFireScheduler */
 	virtual void Fire();
 
+	/**
+	 * 负责一次射击的全部流程：生成投射物、播放反馈、消耗弹药
+	 * @param ShotAge	开火时刻距当前世界时间的秒数（调度器在帧内补发时大于 0）
+	 * @return			是否开火（已松开扳机或需要换弹时返回 false，UShooterFireScheduler 据此停止调度）
+	 */
+	bool FireShot(float ShotAge);
+
+	/** 开始由调度器驱动的全自动射击 */
+	void ScheduleFullAuto(double NextShotTime);
+
 	/** 半自动模式下计时结束后调用，通知角色可以再次射击 */
 	void FireCooldownExpired();
 
-	/** 在目标方向上生成投射物并播放反馈 */
-	virtual void FireProjectile(const FVector &TargetLocation);
+	/**
+	 * 在目标方向上生成一次齐射（PelletCount 颗投射物）并播放反馈
+	 * @param ShotAge		投射物沿轨迹提前飞行的秒数，使帧内开火的投射物处在它应在的位置
+	 * @param InShotIndex	本次射击的序号，决定散布；转发射击事件时必须一起携带，接收端不能用自己的计数
+	 */
+	virtual void FireProjectile(const FVector &TargetLocation, float ShotAge, uint32 InShotIndex);
 
 	/** 计算投射物生成的坐标与朝向（含枪口偏移与散布） */
 	FTransform CalculateProjectileSpawnTransform(const FVector &TargetLocation) const;
 
+	/** 以一次瞄准结果计算整次齐射的弹丸变换，按 SpreadPattern 围绕瞄准方向展开 */
+	void CalculatePelletTransforms(const FVector &TargetLocation, TArray<FTransform> &OutTransforms) const;
+
+	/** 射击者的网络稳定标识（PlayerState 的 PlayerId，没有 PlayerState 时为 0） */
+	int32 GetShooterId() const;
+
 public:
 	/** 返回第一人称网格组件，供 Player 角色挂载 */
 	UFUNCTION(BlueprintPure, Category = "Weapon")
@@ -155,4 +215,25 @@ public:
 
 	/** 查询当前弹匣剩余子弹 */
 	int32 GetBulletCount() const { return CurrentBullets; }
+
+	/** 射击间隔（秒） */
+	float GetRefireRate() const { return RefireRate; }
+
+	/** 下一次射击的序号，与对局种子和射击者标识一起即可重建该次散布 */
+	uint32 GetShotIndex() const { return ShotIndex; }
+
+	/**
+	 * 生成某一次射击的散布随机数流
+	 * 任何一端拿到相同的三个值都能得到相同的散布，不需要同步完整的投射物方向
+	 */
+	static FRandomStream MakeSpreadStream(int32 MatchSeed, int32 ShooterId, uint32 InShotIndex);
+
+	/**
+	 * 预测朝当前瞄准点发射（不含散布）的投射物轨迹，用于预览弧线
+	 * @param Duration		预测时长（秒）
+	 * @param NumPoints		采样点数
+	 * @param OutPoints		轨迹点（世界坐标）
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Aim")
+	void GetTrajectoryPreview(float Duration, int32 NumPoints, TArray<FVector> &OutPoints) const;
 };